@@ -0,0 +1,78 @@
+// analysis_jobs.h - Long-running analyses as time-sliced coroutine jobs
+#ifndef ANALYSIS_JOBS_H
+#define ANALYSIS_JOBS_H
+
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "job_system.h"
+#include "kernels.h"
+#include "result_cache.h"
+
+// Local maxima of z after a transient, for rho swept over [rho_min, rho_max]
+struct BifurcationSettings {
+    float sigma = 10.0f;
+    float beta = 8.0f / 3.0f;
+    float rho_min = 20.0f;
+    float rho_max = 180.0f;
+    glm::vec3 start{1.0f, 1.0f, 1.0f};
+    float dt = 0.005f;
+    int columns = 320;
+    long transient_steps = 4000;
+    int maxima_per_column = 48;
+};
+
+struct BifurcationResult {
+    BifurcationSettings settings;
+    std::vector<glm::vec2> points;      // (rho, z max)
+};
+
+float bifurcationRho(const BifurcationSettings& settings, int column);
+
+// One column: a full transient from settings.start, then up to
+// maxima_per_column maxima. Columns do not depend on each other, so the
+// interactive sweep and any split into chunks give the same points.
+void bifurcationColumn(const BifurcationSettings& settings, int column, std::vector<float>& maxima);
+
+// Columns [first, first + count) without yielding, for distributed sweeps;
+// maxima[i] gets column first + i
+void bifurcationChunk(const BifurcationSettings& settings, int first, int count,
+                      std::vector<std::vector<float>>& maxima);
+
+// With a cache, the finished result is also stored under cacheKey(settings)
+Job bifurcationSweep(JobContext& ctx, BifurcationSettings settings, Published<BifurcationResult>& out,
+                     ResultCache* cache = nullptr);
+
+// Largest Lyapunov exponent by Benettin's method: a companion trajectory
+// `separation` away is pulled back to that distance every `renormalize`
+// steps, and the log stretch factors are averaged over time. The states are
+// floats, so the separation stays well above their rounding error (~1e-6 at
+// |x| ~ 20); for rho = 28 this converges to ~0.906
+struct LyapunovSettings {
+    LorenzParams params{10.0f, 28.0f, 8.0f / 3.0f};
+    glm::vec3 start{0.0f, 1.0f, 0.0f};
+    float dt = 0.01f;
+    long steps = 2000000;
+    int renormalize = 10;
+    float separation = 1e-3f;
+};
+
+struct LyapunovResult {
+    LyapunovSettings settings;
+    double exponent = 0.0;
+    std::vector<float> convergence;     // Running estimate, sampled along the run
+};
+
+Job largestLyapunov(JobContext& ctx, LyapunovSettings settings, Published<LyapunovResult>& out,
+                    ResultCache* cache = nullptr);
+
+// Every input the result depends on. Bump the version string when an
+// analysis changes what it computes, so stale entries stop matching.
+CacheKey cacheKey(const BifurcationSettings& settings);
+CacheKey cacheKey(const LyapunovSettings& settings);
+
+// Publish a stored result for these settings; false on a miss
+bool loadCached(ResultCache& cache, const BifurcationSettings& settings, Published<BifurcationResult>& out);
+bool loadCached(ResultCache& cache, const LyapunovSettings& settings, Published<LyapunovResult>& out);
+
+#endif // ANALYSIS_JOBS_H
@@ -0,0 +1,55 @@
+// anti_aliasing.h - Selectable anti-aliasing modes with per-mode GPU cost
+#ifndef ANTI_ALIASING_H
+#define ANTI_ALIASING_H
+
+#include <glad/glad.h>
+
+#include "framebuffer.h"
+#include "fullscreen_pass.h"
+#include "gpu_timer.h"
+
+enum class AaMode {
+    None,
+    Msaa,           // Multisampled scene target, resolved by the blit out of it
+    Fxaa,           // Single-sample scene, FXAA-style post pass
+    AnalyticLines,  // Lines expanded to quads with exact edge coverage
+    Count
+};
+
+// The window framebuffer is single-sample; all anti-aliasing happens in the
+// scene's own targets. Every mode has its own GPU timer around the scene
+// pass, so the cheapest acceptable mode can be picked per machine.
+class AntiAliasing {
+public:
+    AntiAliasing();
+
+    AaMode mode = AaMode::Msaa;
+    int msaa_samples = 4;
+
+    // Sample count for the scene target under the current mode
+    int sceneSamples() const;
+    bool postProcess() const { return mode == AaMode::Fxaa; }
+    // Line programs come from TrailShaders with line_aa.geom/.frag
+    bool analyticLines() const { return mode == AaMode::AnalyticLines; }
+
+    // Post pass from `source_texture` into `destination` (0 = screen)
+    void apply(GLuint source_texture, GLuint destination, int width, int height) const;
+
+    // Single-sample target for post output that still needs processing
+    GLuint outputTarget(int width, int height);
+    GLuint outputTexture() const { return output_.colorTexture(); }
+
+    GpuTimer& timer() { return timers_[static_cast<int>(mode)]; }
+    const GpuTimer& timer(AaMode m) const { return timers_[static_cast<int>(m)]; }
+
+    int maxSamples() const { return max_samples_; }
+    static const char* modeName(AaMode mode);
+
+private:
+    FullscreenPass fxaa_;
+    Framebuffer output_;
+    GpuTimer timers_[static_cast<int>(AaMode::Count)];
+    int max_samples_ = 0;
+};
+
+#endif // ANTI_ALIASING_H
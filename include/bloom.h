@@ -0,0 +1,50 @@
+// bloom.h - Dual-filter (Kawase) bloom on a half-float mip chain
+#ifndef BLOOM_H
+#define BLOOM_H
+
+#include <memory>
+#include <vector>
+#include <glad/glad.h>
+
+#include "framebuffer.h"
+#include "fullscreen_pass.h"
+#include "gpu_timer.h"
+
+// Bright parts of the scene are thresholded into a half-resolution RGBA16F
+// level, then repeatedly halved with a 5-tap filter and walked back up with
+// an 8-tap one (Bjorge, "Bandwidth-Efficient Rendering", SIGGRAPH 2015).
+// Each tap is bilinear, so a wide kernel costs a few reads per pixel at
+// ever-smaller sizes instead of a full-resolution Gaussian.
+class Bloom {
+public:
+    Bloom();
+
+    // Blur the bright parts of `scene_texture` (width x height) and write
+    // scene + glow into `destination` (0 = default framebuffer). Timed.
+    void apply(GLuint scene_texture, GLuint destination, int width, int height);
+
+    // Single-sample target for output that still needs processing
+    GLuint outputTarget(int width, int height);
+    GLuint outputTexture() const { return output_.colorTexture(); }
+
+    const GpuTimer& timer() const { return timer_; }
+
+    bool enabled = false;
+    float threshold = 0.6f;    // Luma where glow starts
+    float intensity = 0.8f;
+    int levels = 5;            // Mip levels below half resolution, 1..8
+
+private:
+    void resizeChain(int width, int height);
+
+    std::vector<std::unique_ptr<Framebuffer>> mips_;   // [0] = half resolution
+    Framebuffer output_;
+    FullscreenPass downsample_;
+    FullscreenPass upsample_;
+    FullscreenPass composite_;
+    GpuTimer timer_;
+    int chain_width_ = 0;
+    int chain_height_ = 0;
+};
+
+#endif // BLOOM_H
@@ -36,6 +36,9 @@ public:
     
     // Reset camera to default
     void reset();
+    
+    // Bumped by every control call; lets renderers detect camera changes
+    unsigned long getRevision() const { return revision; }
 
 private:
     // Default values (for reset)
@@ -43,6 +46,8 @@ private:
     float default_yaw;
     float default_pitch;
     glm::vec3 default_target;
+    
+    unsigned long revision = 0;
 };
 
 #endif
\ No newline at end of file
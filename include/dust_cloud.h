@@ -0,0 +1,73 @@
+// dust_cloud.h - Particle cloud advected by the Lorenz flow, streamed to the GPU
+#ifndef DUST_CLOUD_H
+#define DUST_CLOUD_H
+
+#include <cstddef>
+#include <memory>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "ensemble.h"
+#include "worker_pool.h"
+
+// The particles live in an Ensemble (SoA, stepped by pinned workers). Right
+// after stepping its slice, each worker copies it into a persistently mapped
+// vertex buffer, so the upload costs no extra pass over the arrays and no
+// driver copy. The buffer holds two frames: workers fill one region while the
+// GPU may still read the other, and a fence per region keeps a write from
+// overtaking the draw that last read it.
+//
+// The workers are the caller's pool, shared with the rest of the frame's
+// data-parallel work, so the cloud adds no threads of its own.
+class DustCloud {
+public:
+    explicit DustCloud(WorkerPool& pool);
+    ~DustCloud();
+
+    DustCloud(const DustCloud&) = delete;
+    DustCloud& operator=(const DustCloud&) = delete;
+
+    // (Re)allocate for `count` particles, spread uniformly over a ball
+    void seed(size_t count, const glm::vec3& center, float radius);
+
+    // Advance every particle and stream the result into the next region
+    void advance(const LorenzParams& params, float dt, long steps);
+
+    // Point sprites from the latest region; the dust program is bound by the caller
+    void draw();
+
+    // Free the particles and the buffer (e.g. while the GPU integrator is used)
+    void release();
+
+    size_t size() const { return ensemble_ ? ensemble_->size() : 0; }
+    int threads() const { return pool_.size(); }
+
+    // False when GL_ARB_buffer_storage is missing and regions go through glBufferSubData
+    bool persistent() const { return persistent_; }
+
+    // Time the last advance() spent waiting for the GPU to release its region
+    double fenceWaitMs() const { return fence_wait_ms_; }
+
+private:
+    static constexpr int kRegions = 2;
+
+    void allocate(size_t count);
+    void waitRegion(int region);
+    void stream(const LorenzParams& params, float dt, long steps);
+
+    WorkerPool& pool_;
+    std::unique_ptr<Ensemble> ensemble_;
+
+    GLuint vbo_ = 0;
+    GLuint vaos_[kRegions] = {};
+    GLsync fences_[kRegions] = {};
+    float* mapped_ = nullptr;        // Persistent mapping of all regions
+    size_t region_bytes_ = 0;
+    bool persistent_ = false;
+
+    int write_region_ = 0;
+    int draw_region_ = -1;           // Region holding the latest positions
+    double fence_wait_ms_ = 0.0;
+};
+
+#endif // DUST_CLOUD_H
@@ -0,0 +1,49 @@
+// dynamic_resolution.h - Scene resolution scaled to hold a GPU time target
+#ifndef DYNAMIC_RESOLUTION_H
+#define DYNAMIC_RESOLUTION_H
+
+#include <glad/glad.h>
+
+#include "framebuffer.h"
+#include "fullscreen_pass.h"
+
+// While the scene pass runs over budget the scene is rendered at a fraction of
+// the window size, then upscaled with a sharpening filter. The GUI is drawn
+// afterwards at native resolution. Scale moves in coarse steps with a
+// cooldown, since each change costs a full trail redraw and the timer lags a
+// few frames behind.
+class DynamicResolution {
+public:
+    DynamicResolution();
+
+    // True while the scene should go through the scaled target
+    bool active() const { return enabled && scale_ < 1.0f; }
+    float scale() const { return scale_; }
+
+    int sceneWidth(int width) const;
+    int sceneHeight(int height) const;
+
+    // Single-sample target for the scene at the current scale (resized as needed)
+    GLuint sceneTarget(int width, int height);
+    GLuint sceneTexture() const { return scene_.colorTexture(); }
+
+    // Sharpened upscale of `texture` (normally sceneTexture()) into the
+    // default framebuffer (width x height)
+    void present(GLuint texture, int width, int height);
+
+    // Feed the scene pass's GPU time (ms) and step the scale toward target_ms
+    void update(double gpu_ms);
+
+    bool enabled = true;
+    float target_ms = 8.0f;     // GPU budget for the scene pass
+    float min_scale = 0.5f;     // Never render below this fraction of native
+    float sharpness = 0.4f;     // 0 = plain bilinear
+
+private:
+    Framebuffer scene_;
+    FullscreenPass upscale_;
+    float scale_ = 1.0f;
+    int cooldown_ = 0;
+};
+
+#endif // DYNAMIC_RESOLUTION_H
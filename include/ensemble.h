@@ -0,0 +1,61 @@
+// ensemble.h - Structure-of-arrays cloud of independent Lorenz states
+#ifndef ENSEMBLE_H
+#define ENSEMBLE_H
+
+#include <cstddef>
+#include <functional>
+#include <glm/glm.hpp>
+
+#include "kernels.h"
+#include "numa_memory.h"
+#include "worker_pool.h"
+
+// x/y/z live in separate huge-page backed arrays. Each pool worker owns a
+// fixed slice: it first-touches that slice at construction and is the only
+// thread that steps it, so pages sit on the worker's NUMA node.
+class Ensemble {
+public:
+    Ensemble(size_t count, WorkerPool& pool, bool explicit_huge = false);
+    ~Ensemble();
+
+    Ensemble(const Ensemble&) = delete;
+    Ensemble& operator=(const Ensemble&) = delete;
+
+    // Uniformly fill a ball (deterministic for a given seed)
+    void seedBall(const glm::vec3& center, float radius, unsigned seed = 1);
+
+    // Advance every state by `steps` RK4 steps on the owning workers
+    void step(const LorenzParams& params, float dt, long steps);
+
+    // Same, then hand each worker's fresh slice [begin, end) to `publish` on
+    // that worker while it is still in cache (e.g. to copy it out for upload)
+    using SliceFn = std::function<void(size_t begin, size_t end)>;
+    void step(const LorenzParams& params, float dt, long steps, const SliceFn& publish);
+
+    size_t size() const { return count_; }
+    float* x() { return x_; }
+    float* y() { return y_; }
+    float* z() { return z_; }
+    const float* x() const { return x_; }
+    const float* y() const { return y_; }
+    const float* z() const { return z_; }
+
+    PageBacking backing() const { return backing_; }
+    size_t bytes() const { return 3 * capacity_bytes_; }
+    WorkerPool& pool() { return pool_; }
+
+    // Slice of the arrays owned by `worker`
+    void range(int worker, size_t& begin, size_t& end) const;
+
+private:
+    size_t count_;
+    size_t capacity_bytes_;
+    size_t granularity_;
+    WorkerPool& pool_;
+    PageBacking backing_ = PageBacking::Small;
+    float* x_ = nullptr;
+    float* y_ = nullptr;
+    float* z_ = nullptr;
+};
+
+#endif // ENSEMBLE_H
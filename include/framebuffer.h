@@ -0,0 +1,60 @@
+// framebuffer.h - Offscreen render targets (FBO + texture attachments)
+#ifndef FRAMEBUFFER_H
+#define FRAMEBUFFER_H
+
+#include <cstddef>
+#include <vector>
+#include <glad/glad.h>
+
+class Framebuffer {
+public:
+    // One texture per entry of color_formats (GL_RGBA8, GL_RGBA16F, ...);
+    // samples > 0 makes every attachment a multisample texture
+    Framebuffer(std::vector<GLenum> color_formats, bool depth, int samples = 0);
+    ~Framebuffer();
+
+    Framebuffer(const Framebuffer&) = delete;
+    Framebuffer& operator=(const Framebuffer&) = delete;
+
+    // (Re)allocate storage; a no-op returning false when nothing changed
+    bool resize(int width, int height);
+    void setSamples(int samples);
+
+    // Bind for drawing and set the viewport to the whole target
+    void bind() const;
+    static void bindDefault(int width, int height);
+
+    // Copy (resolving multisampling) into `target` (0 = default framebuffer)
+    void blitTo(GLuint target, int target_width, int target_height,
+                GLbitfield mask = GL_COLOR_BUFFER_BIT, GLenum filter = GL_NEAREST) const;
+
+    // Copy the colour of `source` (0 = default framebuffer) into this target,
+    // which must be single-sample if the source is multisampled
+    void copyFrom(GLuint source, int source_width, int source_height) const;
+
+    GLuint id() const { return fbo_; }
+    GLuint colorTexture(int index = 0) const { return color_textures_[index]; }
+    GLuint depthTexture() const { return depth_texture_; }
+    int width() const { return width_; }
+    int height() const { return height_; }
+    int samples() const { return samples_; }
+    bool valid() const { return fbo_ != 0; }
+
+    // Estimated GPU memory of all attachments
+    size_t bytes() const;
+
+private:
+    void release();
+
+    std::vector<GLenum> color_formats_;
+    bool has_depth_;
+    int samples_;
+    int width_ = 0;
+    int height_ = 0;
+
+    GLuint fbo_ = 0;
+    std::vector<GLuint> color_textures_;
+    GLuint depth_texture_ = 0;
+};
+
+#endif // FRAMEBUFFER_H
@@ -0,0 +1,34 @@
+// fullscreen_pass.h - Single-triangle full-screen draw with a fragment shader
+#ifndef FULLSCREEN_PASS_H
+#define FULLSCREEN_PASS_H
+
+#include <glad/glad.h>
+
+#include "shader.h"
+
+// Pairs shaders/fullscreen.vert (which outputs `uv`) with any fragment shader.
+// Post-processing and compositing steps are all built on this.
+class FullscreenPass {
+public:
+    explicit FullscreenPass(const char* fragment_path);
+    ~FullscreenPass();
+
+    FullscreenPass(const FullscreenPass&) = delete;
+    FullscreenPass& operator=(const FullscreenPass&) = delete;
+
+    // Activates the program so uniforms can be set before draw()
+    const Shader& use() const;
+
+    // Draws into the bound framebuffer with depth testing off; blend state is
+    // left to the caller
+    void draw() const;
+
+    // use(), bind `texture` to unit 0 as `sampler`, draw()
+    void drawTexture(GLuint texture, const char* sampler) const;
+
+private:
+    Shader shader_;
+    GLuint vao_ = 0;
+};
+
+#endif // FULLSCREEN_PASS_H
@@ -0,0 +1,67 @@
+// gpu_ensemble.h - Particle ensemble stepped by a compute shader, drawn in place
+#ifndef GPU_ENSEMBLE_H
+#define GPU_ENSEMBLE_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "kernels.h"
+#include "shader.h"
+
+// States live in one SSBO that the compute shader steps and the dust program
+// reads as a vertex array, so positions never leave the GPU. Every
+// `check_interval` advances, a sample of particles is read back before and
+// after the dispatch and re-integrated with LorenzSolver on the CPU; the
+// relative error must stay under `tolerance`. Needs GL 4.3 (Mesa llvmpipe has it).
+class GpuEnsemble {
+public:
+    GpuEnsemble();
+    ~GpuEnsemble();
+
+    GpuEnsemble(const GpuEnsemble&) = delete;
+    GpuEnsemble& operator=(const GpuEnsemble&) = delete;
+
+    // GL 4.3 context and a linked compute program
+    bool available() const { return available_; }
+
+    // (Re)allocate for `count` particles, spread uniformly over a ball
+    void seed(size_t count, const glm::vec3& center, float radius, unsigned seed = 1);
+
+    // Advance every particle by `steps` RK4 steps in one dispatch
+    void advance(const LorenzParams& params, float dt, long steps);
+
+    // Point sprites straight from the state buffer (three float attributes,
+    // matching dust.vert); the program is bound by the caller
+    void draw();
+
+    size_t size() const { return count_; }
+
+    struct CheckStats {
+        unsigned long checks = 0;
+        unsigned long failures = 0;
+        float last_error = 0.0f;    // Largest relative error in the last check
+        float max_error = 0.0f;
+    };
+    const CheckStats& checkStats() const { return stats_; }
+
+    int check_interval = 120;       // Advances between cross-checks (0 = never)
+    int check_samples = 64;
+    float tolerance = 1e-3f;
+
+private:
+    void dispatch();
+    void readSamples(std::vector<glm::vec3>& out);
+
+    std::unique_ptr<Shader> program_;     // Built only on GL 4.3 contexts
+    bool available_ = false;
+    GLuint ssbo_ = 0;
+    GLuint vao_ = 0;
+    size_t count_ = 0;
+    unsigned long advances_ = 0;
+    CheckStats stats_;
+};
+
+#endif // GPU_ENSEMBLE_H
@@ -0,0 +1,45 @@
+// gpu_timer.h - Non-blocking GPU pass timing with GL_TIME_ELAPSED queries
+#ifndef GPU_TIMER_H
+#define GPU_TIMER_H
+
+#include <vector>
+#include <glad/glad.h>
+
+// Results arrive a few frames after the commands they measure, so queries are
+// kept in a ring and read back only once available; the CPU never waits on
+// the GPU. If every slot is still in flight, that frame simply goes untimed.
+// GL_TIME_ELAPSED queries cannot nest: time passes one after another.
+class GpuTimer {
+public:
+    explicit GpuTimer(int latency = 4);
+    ~GpuTimer();
+
+    GpuTimer(const GpuTimer&) = delete;
+    GpuTimer& operator=(const GpuTimer&) = delete;
+
+    void begin();
+    void end();
+
+    // Most recent finished measurement and an exponential average, in ms
+    // (0 until the first result comes back)
+    double lastMs() const { return last_ms_; }
+    double averageMs() const { return average_ms_; }
+    unsigned long samples() const { return samples_; }
+
+    void reset();
+
+private:
+    void collect();
+
+    std::vector<GLuint> queries_;
+    std::vector<bool> pending_;
+    int next_ = 0;
+    int oldest_ = 0;
+    bool active_ = false;
+
+    double last_ms_ = 0.0;
+    double average_ms_ = 0.0;
+    unsigned long samples_ = 0;
+};
+
+#endif // GPU_TIMER_H
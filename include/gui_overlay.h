@@ -0,0 +1,49 @@
+// gui_overlay.h - GUI rendered into a cached texture, composited every frame
+#ifndef GUI_OVERLAY_H
+#define GUI_OVERLAY_H
+
+#include <cstdint>
+#include <glad/glad.h>
+
+#include "framebuffer.h"
+#include "fullscreen_pass.h"
+
+// The GUI is only re-rendered when input arrives, when the values it shows
+// change (tracked as a signature), or when the refresh interval runs out.
+// Every other frame just blends the cached texture over the scene.
+class GuiOverlay {
+public:
+    GuiOverlay();
+
+    void resize(int width, int height);
+
+    // Input event: rebuild now and for a few frames after, so widgets settle
+    void markInput();
+
+    bool needsRebuild(double now, uint64_t signature) const;
+
+    // Draws between begin/end go to the cache
+    void beginRebuild();
+    void endRebuild(double now, uint64_t signature);
+
+    void composite();
+
+    // Rebuilds are still pending for widgets to settle after input
+    bool settling() const { return settle_frames_ > 0; }
+
+    bool enabled = true;             // False renders the GUI straight to the screen each frame
+    double refresh_interval = 0.5;   // Seconds
+
+private:
+    Framebuffer target_;
+    FullscreenPass pass_;
+    int width_ = 0;
+    int height_ = 0;
+
+    int settle_frames_ = 0;
+    bool dirty_ = true;
+    double last_rebuild_ = -1.0;
+    uint64_t last_signature_ = 0;
+};
+
+#endif // GUI_OVERLAY_H
@@ -0,0 +1,136 @@
+// hdr_histogram.h - High-dynamic-range histogram for latency percentiles
+#ifndef HDR_HISTOGRAM_H
+#define HDR_HISTOGRAM_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <ostream>
+#include <vector>
+
+// Log-linear buckets in the style of HdrHistogram: values up to `highest` are
+// kept with `significant_digits` of precision in constant memory, so
+// recording is O(1) and percentiles stay accurate out to the far tail.
+class HdrHistogram {
+public:
+    explicit HdrHistogram(uint64_t highest = 60000000, int significant_digits = 3)
+        : highest_(highest)
+    {
+        uint64_t needed = 2;
+        for (int d = 0; d < significant_digits; ++d) needed *= 10;
+        sub_bits_ = 1;
+        while ((uint64_t(1) << sub_bits_) < needed) ++sub_bits_;
+        sub_count_ = uint64_t(1) << sub_bits_;
+        half_count_ = sub_count_ / 2;
+        counts_.assign(indexOf(highest_) + 1, 0);
+    }
+
+    void record(uint64_t value) {
+        value = std::min(value, highest_);
+        ++counts_[indexOf(value)];
+        ++total_;
+        max_ = std::max(max_, value);
+        min_ = std::min(min_, value);
+        sum_ += static_cast<double>(value);
+        sum_sq_ += static_cast<double>(value) * value;
+    }
+
+    void reset() {
+        std::fill(counts_.begin(), counts_.end(), 0);
+        total_ = 0;
+        max_ = 0;
+        min_ = UINT64_MAX;
+        sum_ = sum_sq_ = 0.0;
+    }
+
+    uint64_t count() const { return total_; }
+    uint64_t max() const { return max_; }
+    uint64_t min() const { return total_ ? min_ : 0; }
+    double mean() const { return total_ ? sum_ / total_ : 0.0; }
+    double stddev() const {
+        if (!total_) return 0.0;
+        double m = mean();
+        return std::sqrt(std::max(0.0, sum_sq_ / total_ - m * m));
+    }
+
+    // Smallest recorded-bucket value v such that `percentile`% of samples are <= v
+    uint64_t percentile(double percentile) const {
+        if (!total_) return 0;
+        uint64_t target = static_cast<uint64_t>(std::ceil(percentile / 100.0 * total_));
+        target = std::max<uint64_t>(1, std::min(target, total_));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < counts_.size(); ++i) {
+            seen += counts_[i];
+            if (seen >= target) return std::min(highestEquivalent(i), max_);
+        }
+        return max_;
+    }
+
+    // Percentile distribution in the classic .hgrm text layout; values / scale
+    void writePercentiles(std::ostream& out, double scale, int ticks_per_half = 5) const {
+        out << std::setw(12) << "Value" << " " << std::setw(14) << "Percentile"
+            << " " << std::setw(10) << "TotalCount" << " " << std::setw(14) << "1/(1-Percentile)\n\n";
+        if (total_) {
+            // Step halves the remaining distance to 100% every `ticks_per_half` lines
+            double p = 0.0;
+            for (;;) {
+                uint64_t value = percentile(p);
+                uint64_t below = countAtOrBelow(value);
+                out << std::fixed << std::setprecision(3) << std::setw(12) << value / scale << " "
+                    << std::setprecision(12) << std::setw(14) << p / 100.0 << " "
+                    << std::setw(10) << below << " ";
+                if (p < 100.0) out << std::setprecision(2) << std::setw(14) << 1.0 / (1.0 - p / 100.0);
+                out << "\n";
+                if (p >= 100.0) break;
+                double remaining = 100.0 - p;
+                p += remaining / 2.0 / ticks_per_half;
+                if (below == total_ || remaining < 1e-9) p = 100.0;
+            }
+        }
+        out << std::fixed << std::setprecision(3)
+            << "#[Mean    = " << std::setw(12) << mean() / scale
+            << ", StdDeviation   = " << std::setw(12) << stddev() / scale << "]\n"
+            << "#[Max     = " << std::setw(12) << max_ / scale
+            << ", Total count    = " << std::setw(12) << total_ << "]\n"
+            << "#[Buckets = " << std::setw(12) << counts_.size()
+            << ", SubBuckets     = " << std::setw(12) << sub_count_ << "]\n";
+    }
+
+private:
+    // Bucket 0 is linear over [0, sub_count); after that each power of two
+    // gets half_count slots, i.e. index = shift * half + (value >> shift)
+    size_t indexOf(uint64_t value) const {
+        if (value < sub_count_) return static_cast<size_t>(value);
+        int msb = 63 - __builtin_clzll(value);
+        int shift = msb - (sub_bits_ - 1);
+        return static_cast<size_t>(shift * half_count_ + (value >> shift));
+    }
+
+    uint64_t highestEquivalent(size_t index) const {
+        if (index < sub_count_) return index;
+        uint64_t shift = index / half_count_ - 1;
+        uint64_t sub = index - shift * half_count_;
+        return ((sub + 1) << shift) - 1;
+    }
+
+    uint64_t countAtOrBelow(uint64_t value) const {
+        uint64_t seen = 0;
+        size_t last = indexOf(std::min(value, highest_));
+        for (size_t i = 0; i <= last; ++i) seen += counts_[i];
+        return seen;
+    }
+
+    uint64_t highest_;
+    int sub_bits_ = 1;
+    uint64_t sub_count_ = 2;
+    uint64_t half_count_ = 1;
+    std::vector<uint64_t> counts_;
+    uint64_t total_ = 0;
+    uint64_t max_ = 0;
+    uint64_t min_ = UINT64_MAX;
+    double sum_ = 0.0;
+    double sum_sq_ = 0.0;
+};
+
+#endif // HDR_HISTOGRAM_H
@@ -0,0 +1,21 @@
+// headless.h - Command-line modes that run without opening a window
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+// Argument helpers ("--flag" and "--name value")
+bool has_flag(int argc, char** argv, const char* flag);
+int arg_int(int argc, char** argv, const char* name, int fallback);
+long long arg_long(int argc, char** argv, const char* name, long long fallback);
+float arg_float(int argc, char** argv, const char* name, float fallback);
+const char* arg_string(int argc, char** argv, const char* name, const char* fallback);
+
+// --parareal: parallel-in-time reference run, prints speedup and iterations
+int run_parareal(int argc, char** argv);
+
+// --bench: times the solver kernels on every supported SIMD path, prints JSON
+int run_benchmark(int argc, char** argv);
+
+// --headless: unattended long run with checkpoints and a /metrics endpoint
+int run_headless(int argc, char** argv);
+
+#endif // HEADLESS_H
@@ -0,0 +1,155 @@
+// job_system.h - Time-sliced coroutine jobs for long analyses
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// An analysis is a coroutine returning Job that takes a JobContext&. It calls
+// `co_await ctx.yield()` at convenient points. That is free while its time
+// slice lasts and suspends once the slice is used up, so the scheduler can
+// resume it in a later frame (render thread) or in the next worker round.
+// Cancelling destroys the suspended coroutine, so its locals unwind normally
+// and nothing partial is ever published.
+//
+//     Job sweep(JobContext& ctx, Settings settings, Published<Result>& out) {
+//         for (...) { ...; ctx.setProgress(i / n); co_await ctx.yield(); }
+//         out.publish(std::move(result));
+//     }
+
+class JobContext {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Yield {
+        JobContext* ctx;
+        bool await_ready() const { return Clock::now() < ctx->deadline_; }
+        void await_suspend(std::coroutine_handle<>) const {}
+        void await_resume() const {}
+    };
+
+    Yield yield() { return Yield{this}; }
+
+    void setProgress(float progress) { progress_.store(progress, std::memory_order_relaxed); }
+    float progress() const { return progress_.load(std::memory_order_relaxed); }
+
+private:
+    friend class JobScheduler;
+
+    Clock::time_point deadline_;
+    std::atomic<float> progress_{0.0f};
+};
+
+class Job {
+public:
+    struct promise_type {
+        std::exception_ptr error;
+
+        Job get_return_object() { return Job(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }   // Started by the scheduler
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { error = std::current_exception(); }
+    };
+
+    explicit Job(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+    Job(Job&& other) noexcept : handle_(other.handle_) { other.handle_ = nullptr; }
+    Job& operator=(Job&& other) noexcept;
+    Job(const Job&) = delete;
+    Job& operator=(const Job&) = delete;
+    ~Job() { if (handle_) handle_.destroy(); }
+
+    // Resume until the next suspension; true once the body has finished
+    bool resume();
+
+private:
+    std::coroutine_handle<promise_type> handle_;
+};
+
+// Result slot written once per completed job; readers always see either the
+// previous or the new result, never a half-built one
+template <typename T>
+class Published {
+public:
+    void publish(T value) {
+        auto result = std::make_shared<const T>(std::move(value));
+        std::lock_guard<std::mutex> lock(mutex_);
+        value_ = std::move(result);
+        ++revision_;
+    }
+    std::shared_ptr<const T> get() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return value_;
+    }
+    unsigned long revision() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return revision_;
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::shared_ptr<const T> value_;
+    unsigned long revision_ = 0;
+};
+
+// Frame jobs run on the render thread inside runFrame()'s budget. Worker jobs
+// run round-robin on one background thread, in short slices so that a cancel
+// takes effect quickly.
+class JobScheduler {
+public:
+    using Factory = std::function<Job(JobContext&)>;
+
+    JobScheduler();
+    ~JobScheduler();
+
+    JobScheduler(const JobScheduler&) = delete;
+    JobScheduler& operator=(const JobScheduler&) = delete;
+
+    int start(const std::string& name, const Factory& factory, bool on_worker = false);
+    void cancel(int id);
+
+    // Resume frame jobs until `budget_ms` is spent or all have yielded once
+    void runFrame(double budget_ms);
+
+    struct Info {
+        int id;
+        std::string name;
+        float progress;
+        bool on_worker;
+    };
+    std::vector<Info> jobs() const;
+    bool active() const;
+
+private:
+    struct Entry {
+        int id;
+        std::string name;
+        bool on_worker;
+        std::atomic<bool> cancelled{false};
+        std::atomic<bool> finished{false};
+        std::unique_ptr<JobContext> context;
+        std::unique_ptr<Job> job;
+    };
+
+    void workerLoop();
+    bool step(Entry& entry, double slice_ms);    // True when the entry is finished
+    void reap();
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::vector<std::shared_ptr<Entry>> entries_;
+    int next_id_ = 1;
+    bool stopping_ = false;
+    std::thread worker_;
+};
+
+#endif // JOB_SYSTEM_H
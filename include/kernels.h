@@ -0,0 +1,33 @@
+// kernels.h - Hot solver kernels with runtime instruction-set dispatch
+#ifndef KERNELS_H
+#define KERNELS_H
+
+#include <cstddef>
+
+struct LorenzParams {
+    float sigma;
+    float rho;
+    float beta;
+};
+
+// Instruction-set variants, narrowest first
+enum class SimdPath { Scalar, SSE42, AVX2, AVX512 };
+
+namespace kernels {
+
+// Advance `count` independent states stored as separate x/y/z arrays by
+// `steps` RK4 steps. Results are bit-identical to LorenzSolver::rk4Step.
+void rk4Batch(float* x, float* y, float* z, size_t count,
+              const LorenzParams& params, float dt, long steps);
+
+// Path selection happens once, from cpuid, on first use.
+// LORENZ_SIMD=scalar|sse4.2|avx2|avx512 caps it (e.g. to compare paths).
+SimdPath activePath();
+SimdPath bestPath();
+bool isSupported(SimdPath path);
+bool setPath(SimdPath path);    // False if the CPU (or build) lacks the path
+const char* pathName(SimdPath path);
+
+} // namespace kernels
+
+#endif // KERNELS_H
@@ -2,73 +2,194 @@
 #ifndef LORENZ_SOLVER_H
 #define LORENZ_SOLVER_H
 
+#include <algorithm>
+#include <cstdint>
 #include <vector>
 #include <glm/glm.hpp>
 
+#include "kernels.h"
+#include "memory_tracker.h"
+
+namespace stream { class States; }
+
 class LorenzSolver {
 public:
+    using Trajectory = std::vector<glm::vec3, TrackingAllocator<glm::vec3, MemTag::SolverHistory>>;
+    
     LorenzSolver(float sigma = 10.0f, float rho = 28.0f, float beta = 8.0f/3.0f)
         : sigma_(sigma), rho_(rho), beta_(beta) {
         trajectory_.reserve(50000);
-        trajectory_.push_back(state_);
+        tangents_.reserve(50000);
+        restartHistory();
     }
     
     void setParameters(float sigma, float rho, float beta) {
         sigma_ = sigma;
         rho_ = rho;
         beta_ = beta;
+        derivative_ = derivatives(state_);
     }
     
     void setState(float x, float y, float z) {
         state_ = glm::vec3(x, y, z);
-        trajectory_.clear();
-        trajectory_.push_back(state_);
+        restartHistory();
     }
     
     void step(float dt) {
-        // RK4 integration
-        glm::vec3 k1 = derivatives(state_);
-        glm::vec3 k2 = derivatives(state_ + 0.5f * dt * k1);
-        glm::vec3 k3 = derivatives(state_ + 0.5f * dt * k2);
-        glm::vec3 k4 = derivatives(state_ + dt * k3);
+        // The stored tangents are spliced with one segment duration, so a new
+        // dt starts a new history
+        if (dt != record_dt_) {
+            if (trajectory_.size() > 1) restartHistory();
+            record_dt_ = dt;
+        }
         
-        state_ += (dt / 6.0f) * (k1 + 2.0f*k2 + 2.0f*k3 + k4);
-        trajectory_.push_back(state_);
+        // k1 of this step is f(state_), cached when state_ was produced; the
+        // new f(state) is both the stored tangent and the next step's k1
+        state_ = rk4Step(state_, derivative_, dt);
+        derivative_ = derivatives(state_);
+        if (++steps_since_record_ >= record_stride_) {
+            trajectory_.push_back(state_);
+            tangents_.push_back(derivative_);
+            steps_since_record_ = 0;
+            revision_++;
+        }
+    }
+    
+    // Record only every `stride`-th step; with the stored tangents the
+    // skipped steps can be reconstructed as Hermite segments. A new stride
+    // restarts the history, like a new dt.
+    void setRecordStride(int stride) {
+        stride = std::max(1, stride);
+        if (stride == record_stride_) return;
+        record_stride_ = stride;
+        if (trajectory_.size() > 1) restartHistory();
+    }
+    
+    int getRecordStride() const {
+        return record_stride_;
+    }
+    
+    // dx/dt at an arbitrary state
+    glm::vec3 derivatives(const glm::vec3& state) const {
+        return glm::vec3(
+            sigma_ * (state.y - state.x),
+            state.x * (rho_ - state.z) - state.y,
+            state.x * state.y - beta_ * state.z
+        );
+    }
+    
+    // One RK4 step from an arbitrary state, without touching the trajectory
+    glm::vec3 rk4Step(const glm::vec3& state, float dt) const {
+        return rk4Step(state, derivatives(state), dt);
+    }
+    
+    // Same, with k1 = f(state) already known
+    glm::vec3 rk4Step(const glm::vec3& state, const glm::vec3& k1, float dt) const {
+        glm::vec3 k2 = derivatives(state + 0.5f * dt * k1);
+        glm::vec3 k3 = derivatives(state + 0.5f * dt * k2);
+        glm::vec3 k4 = derivatives(state + dt * k3);
+        
+        return state + (dt / 6.0f) * (k1 + 2.0f*k2 + 2.0f*k3 + k4);
     }
     
-    const std::vector<glm::vec3>& getTrajectory() const {
+    // Propagate a state by `steps` RK4 steps (no history is recorded)
+    glm::vec3 integrate(glm::vec3 state, float dt, long steps) const {
+        for (long i = 0; i < steps; ++i) {
+            state = rk4Step(state, dt);
+        }
+        return state;
+    }
+    
+    // Lazy, unbuffered states from the current one on (see trajectory_stream.h)
+    stream::States stream(float dt) const;
+    
+    const Trajectory& getTrajectory() const {
         return trajectory_;
     }
     
+    // dx/dt at each trajectory point (same length as the trajectory)
+    const Trajectory& getTangents() const {
+        return tangents_;
+    }
+    
     glm::vec3 getState() const {
         return state_;
     }
     
+    LorenzParams getParameters() const {
+        return LorenzParams{sigma_, rho_, beta_};
+    }
+    
     void clearOldest(size_t keep) {
         if (trajectory_.size() > keep) {
+            size_t drop = trajectory_.size() - keep;
             trajectory_.erase(trajectory_.begin(), 
-                            trajectory_.begin() + (trajectory_.size() - keep));
+                            trajectory_.begin() + drop);
+            tangents_.erase(tangents_.begin(), tangents_.begin() + drop);
+            history_start_ += drop;
+            revision_++;
+            history_epoch_++;
         }
     }
     
+    // Drop the oldest points and release capacity until the history (points
+    // and tangents) fits in max_bytes, leaving room for one vector growth.
+    // Returns the points kept.
+    size_t trimHistory(size_t max_bytes) {
+        size_t keep = std::max<size_t>(1, max_bytes / (2 * sizeof(glm::vec3)) / 2);
+        clearOldest(keep);
+        trajectory_.shrink_to_fit();
+        tangents_.shrink_to_fit();
+        return keep;
+    }
+    
     void reset() {
-        trajectory_.clear();
         state_ = glm::vec3(0.0f, 1.0f, 0.0f);
-        trajectory_.push_back(state_);
+        restartHistory();
+    }
+    
+    // Bumped whenever the trajectory changes
+    unsigned long getRevision() const {
+        return revision_;
+    }
+    
+    // Bumped only when points are removed or the history restarts; within one
+    // epoch the trajectory is append-only, so indices stay valid
+    unsigned long getHistoryEpoch() const {
+        return history_epoch_;
+    }
+    
+    // Running index of the first history point: grows by the points dropped
+    // from the front, and past every earlier point on a restart, so an index
+    // never names two different points
+    uint64_t getHistoryStart() const {
+        return history_start_;
     }
 
 private:
-    glm::vec3 derivatives(const glm::vec3& state) const {
-        return glm::vec3(
-            sigma_ * (state.y - state.x),
-            state.x * (rho_ - state.z) - state.y,
-            state.x * state.y - beta_ * state.z
-        );
+    void restartHistory() {
+        derivative_ = derivatives(state_);
+        history_start_ += trajectory_.size();
+        trajectory_.clear();
+        tangents_.clear();
+        trajectory_.push_back(state_);
+        tangents_.push_back(derivative_);
+        steps_since_record_ = 0;
+        revision_++;
+        history_epoch_++;
     }
     
     float sigma_, rho_, beta_;
     glm::vec3 state_{0.0f, 1.0f, 0.0f};
-    std::vector<glm::vec3> trajectory_;
+    glm::vec3 derivative_{0.0f};        // f(state_)
+    Trajectory trajectory_;
+    Trajectory tangents_;
+    int record_stride_ = 1;
+    float record_dt_ = 0.0f;            // dt of the recorded history
+    int steps_since_record_ = 0;
+    unsigned long revision_ = 0;
+    unsigned long history_epoch_ = 0;
+    uint64_t history_start_ = 0;
 };
 
 #endif // LORENZ_SOLVER_H
\ No newline at end of file
@@ -0,0 +1,72 @@
+// memory_tracker.h - Per-subsystem memory accounting with budgets
+#ifndef MEMORY_TRACKER_H
+#define MEMORY_TRACKER_H
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+enum class MemTag {
+    SolverHistory,   // Trajectory points kept for drawing
+    Ensemble,        // Particle clouds (huge-page arrays)
+    Analysis,        // Analysis buffers and caches
+    RenderStaging,   // CPU-side copies prepared for upload
+    GpuBuffers,      // Estimated from the sizes passed to glBufferData & co.
+    OutputStaging,   // Aligned buffers of the trajectory writer
+    Count
+};
+
+namespace memory {
+
+// Counters are lock-free atomics, safe to update from any thread
+void add(MemTag tag, size_t bytes);
+void sub(MemTag tag, size_t bytes);
+void replace(MemTag tag, size_t old_bytes, size_t new_bytes);
+
+size_t live(MemTag tag);
+size_t peak(MemTag tag);
+size_t totalLive();
+const char* tagName(MemTag tag);
+
+// 0 disables the budget. enforceBudgets() (called once per frame on the main
+// thread) runs the trimmer of every subsystem that is over its budget.
+void setBudget(MemTag tag, size_t bytes);
+size_t budget(MemTag tag);
+void setTrimmer(MemTag tag, std::function<void(size_t budget)> trimmer);
+void enforceBudgets();
+
+// Publish live/peak/budget per subsystem through the metrics registry
+void exportMetrics();
+
+} // namespace memory
+
+// std::allocator that charges every allocation to a subsystem
+template <typename T, MemTag Tag>
+struct TrackingAllocator {
+    using value_type = T;
+
+    template <typename U>
+    struct rebind { using other = TrackingAllocator<U, Tag>; };
+
+    TrackingAllocator() = default;
+    template <typename U>
+    TrackingAllocator(const TrackingAllocator<U, Tag>&) {}
+
+    T* allocate(size_t n) {
+        T* ptr = std::allocator<T>().allocate(n);
+        memory::add(Tag, n * sizeof(T));
+        return ptr;
+    }
+
+    void deallocate(T* ptr, size_t n) {
+        memory::sub(Tag, n * sizeof(T));
+        std::allocator<T>().deallocate(ptr, n);
+    }
+
+    template <typename U>
+    bool operator==(const TrackingAllocator<U, Tag>&) const { return true; }
+    template <typename U>
+    bool operator!=(const TrackingAllocator<U, Tag>&) const { return false; }
+};
+
+#endif // MEMORY_TRACKER_H
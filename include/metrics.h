@@ -0,0 +1,66 @@
+// metrics.h - Lock-free counters and gauges with Prometheus text exposition
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+
+struct Counter {
+    std::atomic<uint64_t> value{0};
+    void add(uint64_t n) { value.fetch_add(n, std::memory_order_relaxed); }
+};
+
+struct Gauge {
+    std::atomic<uint64_t> bits{0};   // double stored bitwise so set/get stay lock-free
+    void set(double v) {
+        uint64_t b;
+        std::memcpy(&b, &v, sizeof(b));
+        bits.store(b, std::memory_order_relaxed);
+    }
+    double get() const {
+        uint64_t b = bits.load(std::memory_order_relaxed);
+        double v;
+        std::memcpy(&v, &b, sizeof(v));
+        return v;
+    }
+};
+
+// Register once at startup and keep the returned reference: hot loops only
+// touch the atomics, and a scrape never takes a lock the producers hold.
+class MetricsRegistry {
+public:
+    static MetricsRegistry& instance();
+
+    Counter& counter(const char* name, const char* help, const char* labels = "");
+    Gauge& gauge(const char* name, const char* help, const char* labels = "");
+    // Evaluated on the scraping thread; must only read atomics
+    void callback(const char* name, const char* help, const char* labels,
+                  std::function<double()> read);
+
+    // Prometheus text format 0.0.4
+    std::string exposition() const;
+
+private:
+    enum class Kind { Counter, Gauge, Callback };
+    struct Entry {
+        std::string name;
+        std::string help;
+        std::string labels;
+        Kind kind;
+        Counter counter;
+        Gauge gauge;
+        std::function<double()> read;
+    };
+
+    Entry& add(const char* name, const char* help, const char* labels, Kind kind);
+
+    mutable std::mutex mutex_;   // Guards registration only
+    std::deque<Entry> entries_;  // Stable addresses
+};
+
+#endif // METRICS_H
@@ -0,0 +1,31 @@
+// metrics_server.h - Minimal localhost HTTP listener serving /metrics
+#ifndef METRICS_SERVER_H
+#define METRICS_SERVER_H
+
+#include <atomic>
+#include <thread>
+
+// Serves MetricsRegistry::exposition() on 127.0.0.1:<port> from its own
+// thread. Requests are handled one at a time; scrapes are small and rare.
+class MetricsServer {
+public:
+    explicit MetricsServer(int port);
+    ~MetricsServer();
+
+    MetricsServer(const MetricsServer&) = delete;
+    MetricsServer& operator=(const MetricsServer&) = delete;
+
+    bool start();   // False if the port cannot be bound
+    void stop();
+    int port() const { return port_; }
+
+private:
+    void serve();
+
+    int port_;
+    int listen_fd_ = -1;
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+};
+
+#endif // METRICS_SERVER_H
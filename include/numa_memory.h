@@ -0,0 +1,31 @@
+// numa_memory.h - Huge-page backed allocations and NUMA topology discovery
+#ifndef NUMA_MEMORY_H
+#define NUMA_MEMORY_H
+
+#include <cstddef>
+#include <vector>
+
+constexpr size_t kHugePageSize = 2u << 20;   // 2 MB (x86-64 transparent/explicit huge page)
+constexpr size_t kSmallPageSize = 4096;
+
+struct NumaTopology {
+    std::vector<std::vector<int>> node_cpus;   // Online CPUs of each memory node
+
+    // Read from /sys on Linux; a single node holding every CPU elsewhere
+    static const NumaTopology& get();
+
+    int nodeCount() const { return static_cast<int>(node_cpus.size()); }
+};
+
+enum class PageBacking { Small, Transparent, Explicit };
+
+// Page-aligned anonymous memory. Pages are NOT touched here: the first write
+// decides which node they live on, so callers fill them from the owning worker.
+// explicit_huge asks for MAP_HUGETLB (needs a reserved hugetlbfs pool) and
+// falls back to transparent huge pages (madvise) when that fails.
+void* huge_alloc(size_t bytes, bool explicit_huge, PageBacking* backing = nullptr);
+void huge_free(void* ptr, size_t bytes);
+
+const char* backing_name(PageBacking backing);
+
+#endif // NUMA_MEMORY_H
@@ -0,0 +1,57 @@
+// parareal.h - Parareal parallel-in-time integration of a single trajectory
+#ifndef PARAREAL_H
+#define PARAREAL_H
+
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "lorenz_solver.h"
+
+struct PararealConfig {
+    float t_end = 10.0f;        // Total integration time
+    float fine_dt = 0.001f;     // Step of the accurate (fine) propagator
+    float coarse_dt = 0.02f;    // Step of the cheap (coarse) predictor
+    int slices = 16;            // Number of time slices
+    int max_iterations = 16;    // Upper bound (Parareal is exact after `slices` iterations)
+    float tolerance = 1e-4f;    // Max slice-boundary update that counts as converged
+    int threads = 0;            // 0 = std::thread::hardware_concurrency()
+};
+
+struct PararealResult {
+    std::vector<glm::vec3> boundaries;      // State at the start of each slice, plus the final state
+    std::vector<float> iteration_updates;   // Max boundary update per iteration
+    int iterations = 0;
+    bool converged = false;
+
+    double serial_seconds = 0.0;            // Reference: fine propagator run sequentially
+    double parareal_seconds = 0.0;
+    double speedup = 0.0;
+
+    float error_vs_serial = 0.0f;           // |final state - serial fine final state|
+    float lyapunov_exponent = 0.0f;         // Estimated largest exponent along the run
+    float horizon = 0.0f;                   // Time beyond which `tolerance` cannot be held
+};
+
+class Parareal {
+public:
+    Parareal(const LorenzSolver& system, const PararealConfig& config);
+
+    // Integrate from `initial` to config.t_end; also times a serial reference run
+    PararealResult run(const glm::vec3& initial) const;
+
+private:
+    glm::vec3 coarse(const glm::vec3& state) const;
+    glm::vec3 fine(const glm::vec3& state) const;
+    void fineBatch(const std::vector<glm::vec3>& in, std::vector<glm::vec3>& out,
+                   int begin, int end) const;
+
+    const LorenzSolver& system_;
+    PararealConfig config_;
+    long coarse_steps_;   // Coarse steps per slice
+    long fine_steps_;     // Fine steps per slice
+};
+
+// Largest Lyapunov exponent by renormalised separation of two nearby trajectories
+float estimate_lyapunov(const LorenzSolver& system, glm::vec3 state, float dt, float duration);
+
+#endif // PARAREAL_H
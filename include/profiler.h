@@ -0,0 +1,102 @@
+// profiler.h - Scoped timing zones with optional hardware performance counters
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Cycles, instructions, cache and branch misses of the calling thread
+// (Linux perf_event_open, user space only)
+struct HwCounters {
+    uint64_t cycles = 0;
+    uint64_t instructions = 0;
+    uint64_t cache_misses = 0;
+    uint64_t branch_misses = 0;
+};
+
+// Raw running totals of a counter group, with the time it was enabled and
+// actually counting. Under multiplexing only deltas can be extrapolated.
+struct CounterSample {
+    HwCounters raw;
+    uint64_t time_enabled = 0;
+    uint64_t time_running = 0;
+};
+
+struct ZoneStats {
+    std::string name;
+    uint64_t calls = 0;
+    uint64_t items = 0;       // Work units (steps, points, ...) for per-item rates
+    double seconds = 0.0;
+    HwCounters hw;
+    bool has_hw = false;
+
+    double ipc() const {
+        return hw.cycles ? static_cast<double>(hw.instructions) / hw.cycles : 0.0;
+    }
+    double perItem(uint64_t value) const {
+        return items ? static_cast<double>(value) / items : 0.0;
+    }
+};
+
+class Profiler {
+public:
+    static Profiler& instance();
+
+    // Counters cost two read() syscalls per zone, so they are opt-in
+    void enableCounters(bool enable);
+    bool countersEnabled() const { return counters_enabled_.load(std::memory_order_relaxed); }
+    bool countersAvailable() const;
+
+    void record(const char* name, double seconds, uint64_t items, const HwCounters* hw);
+
+    // Per-frame averages are republished every ~250 ms
+    void endFrame();
+    std::vector<ZoneStats> snapshot() const;   // Last published, per frame
+    std::vector<ZoneStats> totals() const;     // Everything since start
+
+    // Sample the calling thread's counter group; false if unavailable
+    static bool readCounters(CounterSample& out);
+
+    // Counts between two samples, extrapolated to the whole interval when
+    // the group was multiplexed for part of it
+    static HwCounters delta(const CounterSample& start, const CounterSample& end);
+
+private:
+    Profiler();
+
+    static ZoneStats& find(std::vector<ZoneStats>& zones, const char* name);
+
+    std::atomic<bool> counters_enabled_{false};
+    mutable std::mutex mutex_;
+    std::vector<ZoneStats> current_;
+    std::vector<ZoneStats> published_;
+    std::vector<ZoneStats> totals_;
+    int frames_ = 0;
+    std::chrono::high_resolution_clock::time_point publish_timer_;
+};
+
+// Times its scope (and samples counters when enabled) into the named zone
+class ProfileZone {
+public:
+    explicit ProfileZone(const char* name, uint64_t items = 0);
+    ~ProfileZone();
+
+    void addItems(uint64_t items) { items_ += items; }
+
+private:
+    const char* name_;
+    uint64_t items_;
+    bool counting_;
+    CounterSample start_hw_;
+    std::chrono::high_resolution_clock::time_point start_;
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#define PROFILE_ZONE(...) ProfileZone PROFILE_CONCAT(profile_zone_, __LINE__)(__VA_ARGS__)
+
+#endif // PROFILER_H
@@ -0,0 +1,92 @@
+// result_cache.h - Content-addressed on-disk cache for analysis results
+#ifndef RESULT_CACHE_H
+#define RESULT_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+// Content address of a result: FNV-1a over every input that determines it
+// (system, parameters, integrator, dt, seed state, analysis settings), in two
+// independently seeded 64-bit lanes
+class CacheKey {
+public:
+    explicit CacheKey(const std::string& analysis);
+
+    CacheKey& add(double value);
+    CacheKey& add(const std::string& text);
+
+    uint64_t lo() const { return lo_; }
+    uint64_t hi() const { return hi_; }
+    std::string hex() const;
+
+private:
+    void mix(const void* data, size_t bytes);
+
+    uint64_t lo_;
+    uint64_t hi_;
+};
+
+// One file per result, `<key>.lzr`, holding a small header and the raw payload.
+// Loads map the file read-only, so a hit costs an open and an mmap whatever
+// the size. Writes go to a temporary file that is renamed into place, so
+// concurrent processes never see half a result. The modification time is the
+// LRU clock: a load touches it, and a store evicts the oldest files until the
+// directory fits the size limit.
+class ResultCache {
+public:
+    // Read-only mapping of a stored payload; empty on a miss
+    class Blob {
+    public:
+        Blob() = default;
+        ~Blob();
+        Blob(Blob&& other) noexcept;
+        Blob& operator=(Blob&& other) noexcept;
+        Blob(const Blob&) = delete;
+        Blob& operator=(const Blob&) = delete;
+
+        explicit operator bool() const { return map_ != nullptr; }
+        const void* data() const;
+        size_t size() const { return payload_bytes_; }
+
+    private:
+        friend class ResultCache;
+
+        void* map_ = nullptr;
+        size_t map_bytes_ = 0;
+        size_t payload_bytes_ = 0;
+    };
+
+    explicit ResultCache(const std::string& directory = defaultDirectory(), size_t limit_bytes = 256u << 20);
+
+    Blob load(const CacheKey& key);
+    bool store(const CacheKey& key, const void* data, size_t bytes);
+
+    void setLimit(size_t limit_bytes);
+    void clear();
+
+    const std::string& directory() const { return directory_; }
+    size_t limit() const { return limit_; }
+    size_t bytes() const;       // On disk, as of the last scan
+    size_t entries() const;
+    size_t hits() const;
+    size_t misses() const;
+
+    // $LORENZ_CACHE_DIR, else $XDG_CACHE_HOME/lorenz_viz, else ~/.cache/lorenz_viz
+    static std::string defaultDirectory();
+
+private:
+    std::string pathFor(const CacheKey& key) const;
+    void evict(const std::string& keep);   // Caller holds mutex_
+
+    std::string directory_;
+    size_t limit_;
+    mutable std::mutex mutex_;
+    size_t bytes_ = 0;
+    size_t entries_ = 0;
+    size_t hits_ = 0;
+    size_t misses_ = 0;
+};
+
+#endif // RESULT_CACHE_H
@@ -5,12 +5,26 @@
 #include <string>
 #include <glad/glad.h>
 
+// File paths per stage; nullptr stages are left out of the program
+struct ShaderSources {
+    const char* vertex = nullptr;
+    const char* fragment = nullptr;
+    const char* geometry = nullptr;
+    const char* tessControl = nullptr;
+    const char* tessEvaluation = nullptr;
+    const char* compute = nullptr;      // Alone: a compute program (GL 4.3)
+};
+
 class Shader {
 public:
     GLuint ID;
     
-    // Constructor reads and builds the shader
-    Shader(const char* vertexPath, const char* fragmentPath);
+    // Constructor reads and builds the shader; the geometry stage is optional
+    Shader(const char* vertexPath, const char* fragmentPath, const char* geometryPath = nullptr);
+    explicit Shader(const ShaderSources& sources);
+    
+    // False if compilation or linking failed (the log was already printed)
+    bool isLinked() const;
     
     // Use/activate the shader
     void use() const;
@@ -20,9 +34,15 @@ public:
     void setInt(const std::string &name, int value) const;
     void setFloat(const std::string &name, float value) const;
     void setMat4(const std::string &name, const float* value) const;
+    void setVec2(const std::string &name, float x, float y) const;
     void setVec3(const std::string &name, float x, float y, float z) const;
     
 private:
+    void build(const ShaderSources& sources);
+    
+    // Read, compile and error-check one stage
+    GLuint compileStage(GLenum type, const char* path, const std::string& label);
+    
     // Utility function for checking shader compilation/linking errors
     void checkCompileErrors(GLuint shader, std::string type);
 };
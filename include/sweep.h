@@ -0,0 +1,16 @@
+// sweep.h - Bifurcation sweeps split across worker processes
+#ifndef SWEEP_H
+#define SWEEP_H
+
+// --sweep: coordinator. Listens on --listen (unix:/path or tcp:host:port),
+// starts --workers N local `--worker` processes, hands out chunks of
+// --chunk columns from a queue and assembles the z maxima. A chunk whose
+// worker disconnects or exceeds --chunk-timeout seconds is re-issued.
+// Remote workers may join at any time with --worker --connect <address>.
+int run_sweep(int argc, char** argv);
+
+// --worker: pulls chunks from --connect until told to stop.
+// --crash-after K exits abruptly on its (K+1)th chunk, to exercise re-issue.
+int run_sweep_worker(int argc, char** argv);
+
+#endif // SWEEP_H
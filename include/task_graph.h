@@ -0,0 +1,75 @@
+// task_graph.h - Frame work as a dependency graph on a worker pool
+#ifndef TASK_GRAPH_H
+#define TASK_GRAPH_H
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <initializer_list>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "worker_pool.h"
+
+// Tasks are added once, each after its dependencies, and the whole graph is
+// re-executed every frame. A task starts as soon as all its dependencies have
+// finished, so independent work overlaps instead of queueing up behind the
+// render thread. Main-affinity tasks (anything touching GL) run on the thread
+// that called run(). That thread also picks up pool tasks while it has nothing
+// of its own. After each run, the longest chain of task durations (the
+// critical path) bounds how fast the frame can get without changing the work.
+class TaskGraph {
+public:
+    using TaskId = int;
+    enum class Affinity { Any, Main };
+
+    explicit TaskGraph(WorkerPool& pool);
+
+    TaskId add(const char* name, std::function<void()> fn,
+               std::initializer_list<TaskId> dependencies = {}, Affinity affinity = Affinity::Any);
+
+    // Execute every task once; returns when all have finished
+    void run();
+
+    // From the last run
+    double wallMs() const { return wall_ms_; }
+    double criticalPathMs() const { return critical_ms_; }
+    const std::vector<TaskId>& criticalPath() const { return critical_path_; }
+    std::string criticalPathNames() const;     // "a > b > c"
+    const char* name(TaskId id) const { return tasks_[id].name; }
+    double durationMs(TaskId id) const { return tasks_[id].duration_ms; }
+    size_t size() const { return tasks_.size(); }
+
+private:
+    struct Task {
+        const char* name;
+        std::function<void()> fn;
+        std::vector<TaskId> dependencies;
+        std::vector<TaskId> dependents;
+        Affinity affinity;
+        int pending = 0;
+        double duration_ms = 0.0;
+    };
+
+    // Run ready tasks until none are left; `main` also takes Main-affinity ones
+    void drain(bool main);
+    void execute(TaskId id);
+    void updateCriticalPath();
+
+    WorkerPool& pool_;
+    std::vector<Task> tasks_;
+
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    std::deque<TaskId> ready_any_;
+    std::deque<TaskId> ready_main_;
+    size_t remaining_ = 0;
+
+    double wall_ms_ = 0.0;
+    double critical_ms_ = 0.0;
+    std::vector<TaskId> critical_path_;
+};
+
+#endif // TASK_GRAPH_H
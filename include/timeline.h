@@ -0,0 +1,101 @@
+// timeline.h - Checkpointed run history with random seek by re-integration
+#ifndef TIMELINE_H
+#define TIMELINE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "kernels.h"
+#include "memory_tracker.h"
+#include "worker_pool.h"
+
+// Solver state at the start of a chunk, with everything needed to replay it
+struct TimelineCheckpoint {
+    uint64_t step;
+    glm::vec3 state;
+    LorenzParams params;
+    float dt;
+};
+
+// Instead of every point, the live run leaves one checkpoint per `interval`
+// steps (32 bytes each), plus one whenever the parameters or dt change so
+// every chunk replays with constant settings. Viewing any span of the run
+// re-integrates the chunks it covers from their checkpoints, in parallel on
+// the caller's worker pool. RK4 is deterministic, so the replay matches the live run
+// bit for bit. Closed chunks stay in an LRU cache, so scrubbing back and
+// forth over a neighbourhood integrates each chunk once.
+//
+// The cache is bounded in bytes, not chunks. A wide span is sampled with a
+// coarse stride, so it covers many chunks of few points each: a 10M-step span
+// is ~9.8k chunks, which a chunk count limit would evict while replaying it.
+// A window holds at most its own sample count in points, so any window the
+// viewer asks for (Max Points samples) fits well inside the default limit.
+class Timeline {
+public:
+    using Points = std::vector<glm::vec3, TrackingAllocator<glm::vec3, MemTag::Analysis>>;
+
+    explicit Timeline(WorkerPool& pool, uint64_t interval = 1024, size_t cache_bytes = 64u << 20);
+
+    // Call before every live step with the state it starts from
+    void record(const glm::vec3& state, const LorenzParams& params, float dt);
+
+    // Forget the run (e.g. after the solver was reset)
+    void clear();
+
+    // Points and their derivatives at steps [first, last) that are multiples
+    // of `stride`. Tangents are per step (dx/dt times that chunk's dt), so a
+    // span recorded with several dt values still splices correctly.
+    void window(uint64_t first, uint64_t last, uint64_t stride, Points& points, Points& tangents);
+
+    uint64_t steps() const { return steps_; }
+    uint64_t interval() const { return interval_; }
+    size_t checkpoints() const { return checkpoints_.size(); }
+    size_t checkpointBytes() const { return checkpoints_.capacity() * sizeof(TimelineCheckpoint); }
+
+    // Replay statistics of the last window() call
+    size_t lastHits() const { return last_hits_; }
+    size_t lastMisses() const { return last_misses_; }
+    double lastReplayMs() const { return last_replay_ms_; }
+    size_t cachedChunks() const { return cache_.size(); }
+    size_t cachedBytes() const { return cache_bytes_; }
+
+private:
+    struct Chunk {
+        Points points;
+        Points tangents;
+    };
+    using Key = std::pair<size_t, uint64_t>;     // Checkpoint index, stride
+    struct KeyHash {
+        size_t operator()(const Key& key) const {
+            return key.first * 1000003u ^ static_cast<size_t>(key.second);
+        }
+    };
+
+    static size_t chunkBytes(const Chunk& chunk);
+    uint64_t chunkEnd(size_t index) const;
+    void replay(size_t index, uint64_t stride, Chunk& out) const;
+    const Chunk* cached(const Key& key);
+    void insert(const Key& key, Chunk&& chunk);
+
+    uint64_t interval_;
+    size_t cache_limit_;            // Bytes
+    size_t cache_bytes_ = 0;
+    uint64_t steps_ = 0;
+    std::vector<TimelineCheckpoint, TrackingAllocator<TimelineCheckpoint, MemTag::Analysis>> checkpoints_;
+
+    // LRU: most recent at the front
+    std::list<std::pair<Key, Chunk>> lru_;
+    std::unordered_map<Key, std::list<std::pair<Key, Chunk>>::iterator, KeyHash> cache_;
+
+    WorkerPool& pool_;
+    size_t last_hits_ = 0;
+    size_t last_misses_ = 0;
+    double last_replay_ms_ = 0.0;
+};
+
+#endif // TIMELINE_H
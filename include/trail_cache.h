@@ -0,0 +1,111 @@
+// trail_cache.h - Incremental trajectory rendering into a persistent FBO
+#ifndef TRAIL_CACHE_H
+#define TRAIL_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "framebuffer.h"
+#include "fullscreen_pass.h"
+
+enum class TrailPrimitive {
+    Lines,              // Straight segments between samples
+    TessellatedSpline,  // Cubic Hermite patches, subdivided by screen length
+    InstancedSpline     // Same curve, fixed subdivision, no tessellation stages
+};
+
+// The trajectory is append-only between history epochs, so with a fixed view
+// every frame only adds segments. They are rasterized on top of the previous
+// frame's trail, kept in a colour+depth target, and the vertex buffer only
+// receives the new points. A full redraw happens when the view changes, the
+// target is resized, or the history epoch moves (eviction, reset).
+//
+// For translucent trails the cache can hold weighted blended OIT targets
+// instead (McGuire & Bavoil 2013). Accumulation (RGBA16F, additive) and
+// revealage (R8, multiplicative) are both order-independent, so new segments
+// still just add onto the cached sums; a composite pass resolves them over
+// the background. These targets are single-sample.
+class TrailCache {
+public:
+    // A multisampled cache is resolved by the blit into the destination
+    explicit TrailCache(int samples);
+    ~TrailCache();
+
+    TrailCache(const TrailCache&) = delete;
+    TrailCache& operator=(const TrailCache&) = delete;
+
+    // Upload new points (and tangents, dx/dt per point, if given) and bring
+    // the cached trail (width x height) up to date, then copy it into
+    // `destination` (0 = default framebuffer) of the same size. The caller
+    // has the program matching the primitive bound with its uniforms set;
+    // `view_signature` hashes everything those uniforms depend on. Full
+    // redraws clear to the current glClearColor.
+    void draw(const glm::vec3* points, const glm::vec3* tangents, size_t count,
+              unsigned long history_epoch, uint64_t view_signature,
+              int width, int height, GLuint destination = 0);
+
+    // Draws the sections between points [first, first + count) of a trail
+    using RangeDrawer = std::function<void(size_t first, size_t count)>;
+
+    // The same caching for geometry owned elsewhere (e.g. TubeMesh): the
+    // drawer renders with its own program and buffers, the cache decides
+    // which range is new
+    void render(const RangeDrawer& draw_range, size_t count, unsigned long history_epoch,
+                uint64_t view_signature, int width, int height, GLuint destination = 0);
+
+    // Spline primitives need tangents; a change forces a full redraw
+    void setPrimitive(TrailPrimitive primitive);
+    TrailPrimitive primitive() const { return primitive_; }
+    int subdivisions = 8;   // Per segment, InstancedSpline only
+
+    // MSAA sample count of the cached image; a change forces a full redraw
+    void setSamples(int samples);
+
+    // Weighted blended OIT; the line shader must then write accumulation and
+    // revealage (its `weightedOit` uniform). A change forces a full redraw.
+    void setOrderIndependent(bool oit);
+    bool orderIndependent() const { return oit_; }
+
+    // False redraws the whole trail every frame, straight into the destination
+    // unless it has to be resolved from the MSAA target
+    bool enabled = true;
+
+    // Last draw(): segments rasterized and whether it was a full redraw
+    size_t segmentsDrawn() const { return segments_drawn_; }
+    bool rebuilt() const { return rebuilt_; }
+
+private:
+    void upload(const glm::vec3* points, const glm::vec3* tangents, size_t count,
+                unsigned long history_epoch);
+    void drawRange(const RangeDrawer& draw_range, size_t first, size_t count);
+    void drawPrimitive(size_t first, size_t count);
+    void clearTarget();
+
+    Framebuffer target_;
+    Framebuffer oit_target_;
+    FullscreenPass composite_;
+    bool oit_ = false;
+    GLuint vao_ = 0;
+    GLuint instanced_vao_ = 0;
+    GLuint vbo_ = 0;
+    GLuint tangent_vbo_ = 0;
+    TrailPrimitive primitive_ = TrailPrimitive::Lines;
+
+    size_t capacity_ = 0;          // Points each buffer can hold
+    size_t uploaded_ = 0;          // Points of the current epoch in the buffer
+    unsigned long upload_epoch_ = 0;
+    bool upload_valid_ = false;
+
+    size_t drawn_ = 0;             // Points of the current epoch in the cached image
+    unsigned long drawn_epoch_ = 0;
+    uint64_t drawn_view_ = 0;
+    bool drawn_valid_ = false;
+
+    size_t segments_drawn_ = 0;
+    bool rebuilt_ = false;
+};
+
+#endif // TRAIL_CACHE_H
@@ -0,0 +1,38 @@
+// trail_shaders.h - Line programs for every trail primitive and AA mode
+#ifndef TRAIL_SHADERS_H
+#define TRAIL_SHADERS_H
+
+#include "shader.h"
+#include "trail_cache.h"
+
+// Straight lines use basic.vert; splines either tessellate (spline.vert/
+// .tesc/.tese) or subdivide instanced strips (spline_instanced.vert). Each
+// pairs with basic.frag, or with line_aa.geom + line_aa.frag for analytic
+// anti-aliasing, which works on whatever lines the earlier stages emit.
+class TrailShaders {
+public:
+    TrailShaders();
+
+    const Shader& get(TrailPrimitive primitive, bool analytic_aa) const;
+
+    // False if the tessellation programs failed to build; use InstancedSpline
+    bool tessellationAvailable() const { return tessellation_ok_; }
+
+    // The primitive actually drawn for a requested one; the trail cache must
+    // use the same, since it issues GL_PATCHES only for TessellatedSpline
+    TrailPrimitive effective(TrailPrimitive primitive) const {
+        if (primitive == TrailPrimitive::TessellatedSpline && !tessellation_ok_) return TrailPrimitive::InstancedSpline;
+        return primitive;
+    }
+
+private:
+    Shader lines_;
+    Shader lines_aa_;
+    Shader tessellated_;
+    Shader tessellated_aa_;
+    Shader instanced_;
+    Shader instanced_aa_;
+    bool tessellation_ok_ = false;
+};
+
+#endif // TRAIL_SHADERS_H
@@ -0,0 +1,157 @@
+// trajectory_stream.h - Lazy, composable ranges of solver states
+#ifndef TRAJECTORY_STREAM_H
+#define TRAJECTORY_STREAM_H
+
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <glm/glm.hpp>
+
+#include "lorenz_solver.h"
+
+// For one-pass consumers (sections, statistics, symbolic coding) that have no
+// use for the stored history:
+//
+//     using stream::every;
+//     using stream::take;
+//     for (const glm::vec3& p : solver.stream(dt) | every(10) | take(1000000)) ...
+//
+// Nothing is buffered. Each adaptor's iterator wraps the one below it, and
+// everything is inline, so the loop above compiles to RK4 steps with a
+// stride counter and a countdown. Ranges hold their source by value and the
+// solver by pointer: it must outlive the stream, and parameter changes show
+// up from the next step. Range-for works with end() being a different type
+// (C++17), which the unbounded stream uses for its sentinel.
+
+namespace stream {
+
+// End of a range that never ends
+struct Unbounded {};
+
+// States starting at `state`, one RK4 step of `dt` apart; the solver's own
+// state and history are untouched
+class States {
+public:
+    States(const LorenzSolver& solver, const glm::vec3& state, float dt)
+        : solver_(&solver), state_(state), dt_(dt) {}
+
+    class iterator {
+    public:
+        iterator(const LorenzSolver* solver, const glm::vec3& state, float dt)
+            : solver_(solver), state_(state), dt_(dt) {}
+
+        const glm::vec3& operator*() const { return state_; }
+        iterator& operator++() {
+            state_ = solver_->rk4Step(state_, dt_);
+            return *this;
+        }
+        bool operator!=(Unbounded) const { return true; }
+
+    private:
+        const LorenzSolver* solver_;
+        glm::vec3 state_;
+        float dt_;
+    };
+
+    iterator begin() const { return iterator(solver_, state_, dt_); }
+    Unbounded end() const { return Unbounded(); }
+
+private:
+    const LorenzSolver* solver_;
+    glm::vec3 state_;
+    float dt_;
+};
+
+// The first element, then every `stride`-th one after it
+template <typename Range>
+class Every {
+public:
+    using Inner = decltype(std::declval<const Range&>().begin());
+    using InnerEnd = decltype(std::declval<const Range&>().end());
+
+    Every(Range range, uint64_t stride) : range_(std::move(range)), stride_(stride ? stride : 1) {}
+
+    class iterator {
+    public:
+        iterator(Inner it, InnerEnd end, uint64_t stride) : it_(it), end_(end), stride_(stride) {}
+
+        decltype(auto) operator*() const { return *it_; }
+        iterator& operator++() {
+            for (uint64_t i = 0; i < stride_ && it_ != end_; ++i) ++it_;
+            return *this;
+        }
+        bool operator!=(Unbounded) const { return it_ != end_; }
+
+    private:
+        Inner it_;
+        InnerEnd end_;
+        uint64_t stride_;
+    };
+
+    iterator begin() const { return iterator(range_.begin(), range_.end(), stride_); }
+    Unbounded end() const { return Unbounded(); }
+
+private:
+    Range range_;
+    uint64_t stride_;
+};
+
+// At most `count` elements
+template <typename Range>
+class Take {
+public:
+    using Inner = decltype(std::declval<const Range&>().begin());
+    using InnerEnd = decltype(std::declval<const Range&>().end());
+
+    Take(Range range, uint64_t count) : range_(std::move(range)), count_(count) {}
+
+    class iterator {
+    public:
+        iterator(Inner it, InnerEnd end, uint64_t left) : it_(it), end_(end), left_(left) {}
+
+        decltype(auto) operator*() const { return *it_; }
+        iterator& operator++() {
+            // The last element is not stepped past, so take(n) costs n - 1 advances
+            if (--left_ > 0) ++it_;
+            return *this;
+        }
+        bool operator!=(Unbounded) const { return left_ > 0 && it_ != end_; }
+
+    private:
+        Inner it_;
+        InnerEnd end_;
+        uint64_t left_;
+    };
+
+    iterator begin() const { return iterator(range_.begin(), range_.end(), count_); }
+    Unbounded end() const { return Unbounded(); }
+
+private:
+    Range range_;
+    uint64_t count_;
+};
+
+// Pipe adaptors: range | every(n) | take(n)
+struct EveryAdaptor { uint64_t stride; };
+struct TakeAdaptor { uint64_t count; };
+
+inline EveryAdaptor every(uint64_t stride) { return EveryAdaptor{stride}; }
+inline TakeAdaptor take(uint64_t count) { return TakeAdaptor{count}; }
+
+template <typename Range>
+Every<std::decay_t<Range>> operator|(Range&& range, EveryAdaptor adaptor) {
+    return Every<std::decay_t<Range>>(std::forward<Range>(range), adaptor.stride);
+}
+
+template <typename Range>
+Take<std::decay_t<Range>> operator|(Range&& range, TakeAdaptor adaptor) {
+    return Take<std::decay_t<Range>>(std::forward<Range>(range), adaptor.count);
+}
+
+} // namespace stream
+
+inline stream::States LorenzSolver::stream(float dt) const {
+    return ::stream::States(*this, state_, dt);   // Unqualified, `stream` is the member
+}
+
+#endif // TRAJECTORY_STREAM_H
@@ -0,0 +1,88 @@
+// trajectory_writer.h - Asynchronous direct-I/O output of trajectory states
+#ifndef TRAJECTORY_WRITER_H
+#define TRAJECTORY_WRITER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <glm/glm.hpp>
+
+class WorkerPool;
+
+// Writes states as raw float x,y,z triples. append() copies into one of two
+// aligned staging buffers. When that buffer is full, it is submitted as a
+// single write at its file offset, and filling continues in the other buffer
+// while the write is in flight. The integrator only waits (a "stall") when it
+// fills a buffer before the disk has finished the previous one.
+//
+// Writes go through io_uring when the kernel allows it. Otherwise each buffer
+// is split into stripes, and a small worker pool pwrite()s them in parallel.
+// The file is opened with O_DIRECT where the filesystem supports it, so the
+// output bypasses the page cache. The final partial buffer is padded to the
+// block size and the file is truncated back to its real length.
+class TrajectoryWriter {
+public:
+    enum class Backend { IoUring, ThreadPool };
+
+    // buffer_bytes is rounded up to kAlignment
+    explicit TrajectoryWriter(const std::string& path, size_t buffer_bytes = 8u << 20,
+                              bool allow_uring = true, bool direct = true);
+    ~TrajectoryWriter();
+
+    TrajectoryWriter(const TrajectoryWriter&) = delete;
+    TrajectoryWriter& operator=(const TrajectoryWriter&) = delete;
+
+    bool ok() const { return fd_ >= 0 && !failed_; }
+
+    void append(const glm::vec3* states, size_t count);
+    bool close();   // Flush, wait for every write and close; false if any write failed
+
+    Backend backend() const { return backend_; }
+    const char* backendName() const { return backend_ == Backend::IoUring ? "io_uring" : "pwrite pool"; }
+    bool direct() const { return direct_; }
+
+    uint64_t bytesWritten() const { return bytes_; }
+    double seconds() const;
+    double megabytesPerSecond() const;
+    double stallMs() const { return stall_ms_; }
+
+    static constexpr size_t kAlignment = 4096;   // O_DIRECT offset/length/address granularity
+
+private:
+    struct Ring;    // io_uring state (mmapped rings)
+
+    void submit(int buffer, size_t bytes);
+    void waitFor(int buffer);
+    void completed(int buffer, int error);   // error is an errno value, 0 on success
+
+    int fd_ = -1;
+    bool direct_ = false;
+    bool failed_ = false;
+    Backend backend_ = Backend::ThreadPool;
+    std::unique_ptr<Ring> ring_;
+    std::unique_ptr<WorkerPool> pool_;
+    std::function<void(int, int)> pool_job_;    // Kept alive while the pool runs it
+    std::atomic<int> pool_error_{0};
+
+    size_t buffer_bytes_;
+    char* buffers_[2] = {nullptr, nullptr};
+    bool in_flight_[2] = {false, false};
+    size_t submitted_bytes_[2] = {0, 0};
+    uint64_t submitted_offset_[2] = {0, 0};
+    bool submitted_direct_[2] = {false, false};     // Submitted while O_DIRECT was on
+    int current_ = 0;
+    size_t fill_ = 0;           // Bytes staged in buffers_[current_]
+    uint64_t file_offset_ = 0;  // Where the next submitted buffer goes
+
+    uint64_t bytes_ = 0;        // Appended (the final file size)
+    double stall_ms_ = 0.0;
+    std::chrono::steady_clock::time_point start_;
+    std::chrono::steady_clock::time_point end_;
+    bool closed_ = false;
+};
+
+#endif // TRAJECTORY_WRITER_H
@@ -0,0 +1,72 @@
+// tube_mesh.h - Lit tube geometry around the trajectory, extended incrementally
+#ifndef TUBE_MESH_H
+#define TUBE_MESH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+// One ring of `sides` vertices per trajectory point, oriented by
+// parallel-transport frames: each ring's normal is the previous one with its
+// component along the new tangent removed, so the tube never twists the way
+// Frenet frames do at inflection points. The vertex buffer is a ring of ring
+// slots: new points write rings after the newest one, and points evicted
+// from the front of the history just advance the oldest slot, so a steady
+// trail streams only its new rings. The index pattern covers every slot,
+// with the last section wrapping to slot 0, so it depends only on the
+// capacity and never streams.
+class TubeMesh {
+public:
+    TubeMesh();
+    ~TubeMesh();
+
+    TubeMesh(const TubeMesh&) = delete;
+    TubeMesh& operator=(const TubeMesh&) = delete;
+
+    // points[0] has the running index `first` (an index never names two
+    // different points). Rings before it are dropped, and the points not
+    // meshed yet are added; only a new ring resolution or radius remeshes
+    // everything. Returns the number of rings generated.
+    size_t update(const glm::vec3* points, const glm::vec3* tangents, size_t count,
+                  uint64_t first, int sides);
+
+    // Draw the sections between points [first, first + count) of the last
+    // update; the tube program is bound by the caller
+    void drawRange(size_t first, size_t count);
+
+    // LOD: ring resolution for a tube whose radius covers `radius_px` pixels
+    static int sidesForRadius(float radius_px);
+
+    float radius = 0.3f;
+
+    int sides() const { return sides_; }
+    size_t rings() const { return rings_; }
+
+private:
+    struct Vertex {
+        glm::vec3 position;
+        glm::vec3 normal;
+    };
+
+    void appendRing(const glm::vec3& point, glm::vec3 tangent);
+    void reserveRings(size_t rings);
+    size_t bufferBytes() const;
+
+    GLuint vao_ = 0;
+    GLuint vbo_ = 0;
+    GLuint ibo_ = 0;
+    size_t capacity_ = 0;            // Ring slots, and sections in the index pattern
+
+    int sides_ = 0;
+    float meshed_radius_ = 0.0f;
+    size_t rings_ = 0;
+    size_t oldest_ = 0;              // Slot of the oldest ring
+    uint64_t first_ = 0;             // Running index of the oldest ring
+    bool valid_ = false;
+    glm::vec3 normal_{0.0f};         // Frame normal of the last ring
+    std::vector<Vertex> staging_;
+};
+
+#endif // TUBE_MESH_H
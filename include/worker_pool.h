@@ -0,0 +1,65 @@
+// worker_pool.h - Persistent, optionally CPU-pinned worker threads
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Every run() hands worker w the same job index, so a static partition of an
+// array maps to the same thread (and, when pinned, the same NUMA node) every
+// time. Memory first-touched by worker w therefore stays local to it.
+class WorkerPool {
+public:
+    // threads <= 0 uses every online CPU; pin binds worker w to cpus()[w]
+    explicit WorkerPool(int threads = 0, bool pin = true);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    // Run job(worker, workers) on every worker and wait for all of them
+    void run(const std::function<void(int, int)>& job);
+
+    // The two halves of run(), so the caller can work meanwhile; `job` must
+    // stay alive until wait() returns. A pool shared by several threads runs
+    // one job at a time: start() waits until the previous job was waited for.
+    void start(const std::function<void(int, int)>& job);
+    void wait();
+
+    int size() const { return static_cast<int>(threads_.size()); }
+    bool pinned() const { return pinned_; }
+    int nodeOf(int worker) const { return worker_nodes_[worker]; }
+
+    // Worker jobs handed out but not yet finished, summed over all pools
+    static int pendingJobs() { return pending_jobs_.load(std::memory_order_relaxed); }
+
+    // [begin, end) of `count` elements owned by `worker`, with boundaries
+    // rounded to `granularity` elements (page size for first-touch placement)
+    static void partition(size_t count, int worker, int workers, size_t granularity,
+                          size_t& begin, size_t& end);
+
+private:
+    void workerLoop(int index);
+
+    std::vector<std::thread> threads_;
+    std::vector<int> worker_nodes_;
+    bool pinned_ = false;
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    std::condition_variable idle_;
+    const std::function<void(int, int)>* job_ = nullptr;
+    unsigned long generation_ = 0;
+    int remaining_ = 0;
+    bool stopping_ = false;
+
+    static std::atomic<int> pending_jobs_;
+};
+
+#endif // WORKER_POOL_H
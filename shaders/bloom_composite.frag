@@ -0,0 +1,14 @@
+// bloom_composite.frag - Fragment Shader adding the bloom glow to the scene
+#version 420 core
+
+in vec2 uv;
+out vec4 FragColor;
+
+uniform sampler2D scene;
+uniform sampler2D bloom;
+uniform float intensity;
+
+void main() {
+    vec3 color = texture(scene, uv).rgb + intensity * texture(bloom, uv).rgb;
+    FragColor = vec4(color, 1.0);
+}
@@ -0,0 +1,26 @@
+// bloom_down.frag - Fragment Shader for the dual-filter bloom downsample (5 taps)
+#version 420 core
+
+in vec2 uv;
+out vec4 FragColor;
+
+uniform sampler2D source;
+uniform vec2 texel;        // 1 / source size
+uniform float threshold;   // < 0: no thresholding (every pass after the first)
+
+void main() {
+    // Centre plus four diagonal taps between texels, each a bilinear 2x2 average
+    vec3 sum = texture(source, uv).rgb * 4.0;
+    sum += texture(source, uv + vec2(-texel.x, -texel.y)).rgb;
+    sum += texture(source, uv + vec2( texel.x, -texel.y)).rgb;
+    sum += texture(source, uv + vec2(-texel.x,  texel.y)).rgb;
+    sum += texture(source, uv + vec2( texel.x,  texel.y)).rgb;
+    vec3 color = sum / 8.0;
+
+    if (threshold >= 0.0) {
+        // Keep only the part of each pixel above the threshold, hue preserved
+        float brightness = max(color.r, max(color.g, color.b));
+        color *= max(brightness - threshold, 0.0) / max(brightness, 1e-4);
+    }
+    FragColor = vec4(color, 1.0);
+}
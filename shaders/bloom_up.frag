@@ -0,0 +1,21 @@
+// bloom_up.frag - Fragment Shader for the dual-filter bloom upsample (8 taps)
+#version 420 core
+
+in vec2 uv;
+out vec4 FragColor;
+
+uniform sampler2D source;
+uniform vec2 halfTexel;    // 0.5 / source (smaller level) size
+
+void main() {
+    // Tent: four edge taps at weight 1, four diagonal taps at weight 2
+    vec3 sum = texture(source, uv + vec2(-2.0 * halfTexel.x, 0.0)).rgb;
+    sum += texture(source, uv + vec2( 2.0 * halfTexel.x, 0.0)).rgb;
+    sum += texture(source, uv + vec2(0.0, -2.0 * halfTexel.y)).rgb;
+    sum += texture(source, uv + vec2(0.0,  2.0 * halfTexel.y)).rgb;
+    sum += texture(source, uv + vec2(-halfTexel.x, -halfTexel.y)).rgb * 2.0;
+    sum += texture(source, uv + vec2( halfTexel.x, -halfTexel.y)).rgb * 2.0;
+    sum += texture(source, uv + vec2(-halfTexel.x,  halfTexel.y)).rgb * 2.0;
+    sum += texture(source, uv + vec2( halfTexel.x,  halfTexel.y)).rgb * 2.0;
+    FragColor = vec4(sum / 12.0, 1.0);
+}
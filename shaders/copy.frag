@@ -0,0 +1,11 @@
+// copy.frag - Fragment Shader copying a texture to the target unchanged
+#version 420 core
+
+in vec2 uv;
+out vec4 FragColor;
+
+uniform sampler2D source;
+
+void main() {
+    FragColor = texture(source, uv);
+}
@@ -0,0 +1,15 @@
+// dust.frag - Fragment Shader for round, soft-edged dust sprites
+#version 420 core
+
+in vec3 fragColor;
+
+uniform float alpha;
+
+out vec4 FragColor;
+
+void main() {
+    vec2 p = gl_PointCoord * 2.0 - 1.0;
+    float r2 = dot(p, p);
+    if (r2 > 1.0) discard;
+    FragColor = vec4(fragColor, alpha * (1.0 - r2));
+}
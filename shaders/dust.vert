@@ -0,0 +1,24 @@
+// dust.vert - Vertex Shader for the advected dust cloud (point sprites)
+#version 420 core
+
+// Positions arrive as three separate arrays, straight from the ensemble
+layout(location = 0) in float aX;
+layout(location = 1) in float aY;
+layout(location = 2) in float aZ;
+
+uniform mat4 view;
+uniform mat4 projection;
+uniform float pointSize;      // Pixels at the orbit distance
+uniform float focusDistance;
+
+out vec3 fragColor;
+
+void main() {
+    vec4 pos = view * vec4(aX, aY, aZ, 1.0);
+    gl_Position = projection * pos;
+    gl_PointSize = clamp(pointSize * focusDistance / max(-pos.z, 0.1), 1.0, 32.0);
+
+    // Height on the attractor: the two lobes sit around z = 27
+    float t = clamp(aZ / 50.0, 0.0, 1.0);
+    fragColor = mix(vec3(0.2, 0.5, 1.0), vec3(1.0, 0.7, 0.3), t);
+}
@@ -0,0 +1,11 @@
+// fullscreen.vert - Vertex Shader for full-screen passes (no vertex buffer)
+#version 420 core
+
+out vec2 uv;
+
+void main() {
+    // One oversized triangle covering the viewport, generated from gl_VertexID
+    vec2 pos = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    uv = pos;
+    gl_Position = vec4(pos * 2.0 - 1.0, 0.0, 1.0);
+}
@@ -0,0 +1,43 @@
+// fxaa.frag - Fragment Shader for FXAA-style post-process anti-aliasing
+#version 420 core
+
+in vec2 uv;
+out vec4 FragColor;
+
+uniform sampler2D source;
+
+const float kReduceMin = 1.0 / 128.0;
+const float kReduceMul = 1.0 / 8.0;
+const float kSpanMax = 8.0;
+
+float luma(vec3 c) {
+    return dot(c, vec3(0.299, 0.587, 0.114));
+}
+
+void main() {
+    vec2 texel = 1.0 / vec2(textureSize(source, 0));
+    float nw = luma(texture(source, uv + vec2(-1.0, -1.0) * texel).rgb);
+    float ne = luma(texture(source, uv + vec2( 1.0, -1.0) * texel).rgb);
+    float sw = luma(texture(source, uv + vec2(-1.0,  1.0) * texel).rgb);
+    float se = luma(texture(source, uv + vec2( 1.0,  1.0) * texel).rgb);
+    vec3 center = texture(source, uv).rgb;
+    float m = luma(center);
+
+    float lo = min(m, min(min(nw, ne), min(sw, se)));
+    float hi = max(m, max(max(nw, ne), max(sw, se)));
+
+    // Blur direction runs along the edge, i.e. across the luma gradient
+    vec2 dir = vec2(-((nw + ne) - (sw + se)), (nw + sw) - (ne + se));
+    float reduce = max((nw + ne + sw + se) * 0.25 * kReduceMul, kReduceMin);
+    float scale = 1.0 / (min(abs(dir.x), abs(dir.y)) + reduce);
+    dir = clamp(dir * scale, vec2(-kSpanMax), vec2(kSpanMax)) * texel;
+
+    vec3 a = 0.5 * (texture(source, uv + dir * (1.0 / 3.0 - 0.5)).rgb +
+                    texture(source, uv + dir * (2.0 / 3.0 - 0.5)).rgb);
+    vec3 b = a * 0.5 + 0.25 * (texture(source, uv - dir * 0.5).rgb +
+                               texture(source, uv + dir * 0.5).rgb);
+
+    // The wider tap set is used unless it reaches past the local contrast range
+    float lb = luma(b);
+    FragColor = vec4((lb < lo || lb > hi) ? a : b, 1.0);
+}
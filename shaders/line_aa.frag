@@ -0,0 +1,29 @@
+// line_aa.frag - Fragment Shader for analytically anti-aliased lines
+#version 420 core
+
+in vec3 lineColor;
+noperspective in float edgeDistance;
+layout(location = 0) out vec4 FragColor;   // Colour, or OIT accumulation
+layout(location = 1) out float Revealage;  // OIT only
+
+uniform float alpha;
+uniform float lineWidth;
+uniform bool weightedOit;
+
+// Weighted blended OIT (McGuire & Bavoil 2013, eq. 10): nearer and more
+// opaque fragments dominate the average
+void writeWeighted(vec4 color) {
+    float w = clamp(pow(min(1.0, color.a * 10.0) + 0.01, 3.0) * 1e8 *
+                    pow(1.0 - gl_FragCoord.z * 0.9, 3.0), 1e-2, 3e3);
+    FragColor = vec4(color.rgb * color.a, color.a) * w;
+    Revealage = color.a;
+}
+
+void main() {
+    // Pixel coverage of a box filter against the line's cross-section
+    float coverage = clamp(lineWidth * 0.5 + 0.5 - abs(edgeDistance), 0.0, 1.0);
+    if (coverage <= 0.0) discard;
+    vec4 color = vec4(lineColor, alpha * coverage);
+    if (weightedOit) writeWeighted(color);
+    else FragColor = color;
+}
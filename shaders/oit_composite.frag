@@ -0,0 +1,17 @@
+// oit_composite.frag - Fragment Shader resolving weighted blended OIT targets
+#version 420 core
+
+in vec2 uv;
+out vec4 FragColor;
+
+uniform sampler2D accum;      // sum(rgb * a * w), sum(a * w)
+uniform sampler2D revealage;  // prod(1 - a)
+
+void main() {
+    float reveal = texture(revealage, uv).r;
+    if (reveal >= 1.0) discard;   // Nothing drawn here
+
+    vec4 sum = texture(accum, uv);
+    vec3 average = sum.rgb / clamp(sum.a, 1e-4, 5e4);
+    FragColor = vec4(average, 1.0 - reveal);
+}
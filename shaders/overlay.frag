@@ -0,0 +1,11 @@
+// overlay.frag - Fragment Shader compositing the cached GUI overlay
+#version 420 core
+
+in vec2 uv;
+out vec4 FragColor;
+
+uniform sampler2D overlay;  // Premultiplied alpha (ImGui blends RGB by alpha, adds alpha)
+
+void main() {
+    FragColor = texture(overlay, uv);
+}
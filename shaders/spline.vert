@@ -0,0 +1,13 @@
+// spline.vert - Vertex Shader passing trajectory samples to the spline tessellator
+#version 420 core
+
+layout(location = 0) in vec3 aPos;
+layout(location = 1) in vec3 aTangent;  // dx/dt at the sample
+
+out vec3 vPos;
+out vec3 vTangent;
+
+void main() {
+    vPos = aPos;
+    vTangent = aTangent;
+}
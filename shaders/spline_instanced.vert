@@ -0,0 +1,39 @@
+// spline_instanced.vert - Vertex Shader for Hermite trail segments without tessellation
+#version 420 core
+
+// One instance per segment: both end samples arrive as instanced attributes
+layout(location = 0) in vec3 aPos0;
+layout(location = 1) in vec3 aTangent0;
+layout(location = 2) in vec3 aPos1;
+layout(location = 3) in vec3 aTangent1;
+
+out vec3 fragColor;
+
+uniform mat4 view;
+uniform mat4 projection;
+uniform float segmentTime;
+uniform int subdivisions;  // Line strip of subdivisions + 1 vertices per segment
+uniform float pointIndex;  // For color gradient
+uniform float totalPoints;
+
+vec3 gradient(float t) {
+    // Blue (start) → Cyan → Green → Yellow → Red (end), as in basic.vert
+    if (t < 0.25) return vec3(0.0, t / 0.25, 1.0);
+    if (t < 0.5) return vec3(0.0, 1.0, 1.0 - (t - 0.25) / 0.25);
+    if (t < 0.75) return vec3((t - 0.5) / 0.25, 1.0, 0.0);
+    return vec3(1.0, 1.0 - (t - 0.75) / 0.25, 0.0);
+}
+
+void main() {
+    float u = float(gl_VertexID) / float(subdivisions);
+    float u2 = u * u;
+    float u3 = u2 * u;
+
+    vec3 pos = (2.0 * u3 - 3.0 * u2 + 1.0) * aPos0 +
+               (u3 - 2.0 * u2 + u) * aTangent0 * segmentTime +
+               (-2.0 * u3 + 3.0 * u2) * aPos1 +
+               (u3 - u2) * aTangent1 * segmentTime;
+
+    gl_Position = projection * view * vec4(pos, 1.0);
+    fragColor = gradient(pointIndex / totalPoints);
+}
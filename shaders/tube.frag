@@ -0,0 +1,31 @@
+// tube.frag - Fragment Shader for the lit trajectory tube (headlight Blinn-Phong)
+#version 420 core
+
+in vec3 viewPos;
+in vec3 viewNormal;
+layout(location = 0) out vec4 FragColor;   // Colour, or OIT accumulation
+layout(location = 1) out float Revealage;  // OIT only
+
+uniform vec3 baseColor;
+uniform float alpha;
+uniform bool weightedOit;
+
+// Weighted blended OIT, as in basic.frag
+void writeWeighted(vec4 color) {
+    float w = clamp(pow(min(1.0, color.a * 10.0) + 0.01, 3.0) * 1e8 *
+                    pow(1.0 - gl_FragCoord.z * 0.9, 3.0), 1e-2, 3e3);
+    FragColor = vec4(color.rgb * color.a, color.a) * w;
+    Revealage = color.a;
+}
+
+void main() {
+    // Light at the eye: L = V
+    vec3 n = normalize(viewNormal);
+    vec3 v = normalize(-viewPos);
+    float diffuse = max(dot(n, v), 0.0);
+    float specular = pow(diffuse, 48.0);   // N.H with H = V
+
+    vec4 color = vec4(baseColor * (0.15 + 0.85 * diffuse) + vec3(0.35 * specular), alpha);
+    if (weightedOit) writeWeighted(color);
+    else FragColor = color;
+}
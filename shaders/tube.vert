@@ -0,0 +1,18 @@
+// tube.vert - Vertex Shader for the lit trajectory tube
+#version 420 core
+
+layout(location = 0) in vec3 aPos;
+layout(location = 1) in vec3 aNormal;
+
+uniform mat4 view;
+uniform mat4 projection;
+
+out vec3 viewPos;
+out vec3 viewNormal;
+
+void main() {
+    vec4 pos = view * vec4(aPos, 1.0);
+    viewPos = pos.xyz;
+    viewNormal = mat3(view) * aNormal;  // The view matrix is rigid
+    gl_Position = projection * pos;
+}
@@ -0,0 +1,24 @@
+// upscale.frag - Fragment Shader for the sharpened upscale of a reduced-resolution scene
+#version 420 core
+
+in vec2 uv;
+out vec4 FragColor;
+
+uniform sampler2D source;
+uniform float sharpness;   // 0 = bilinear only
+
+void main() {
+    vec2 texel = 1.0 / vec2(textureSize(source, 0));
+    vec4 center = texture(source, uv);
+    vec3 n = texture(source, uv + vec2(0.0, texel.y)).rgb;
+    vec3 s = texture(source, uv - vec2(0.0, texel.y)).rgb;
+    vec3 e = texture(source, uv + vec2(texel.x, 0.0)).rgb;
+    vec3 w = texture(source, uv - vec2(texel.x, 0.0)).rgb;
+
+    // Unsharp mask, clamped to the neighbourhood range so edges do not ring
+    vec3 blurred = (n + s + e + w) * 0.25;
+    vec3 sharpened = center.rgb + sharpness * (center.rgb - blurred);
+    vec3 lo = min(center.rgb, min(min(n, s), min(e, w)));
+    vec3 hi = max(center.rgb, max(max(n, s), max(e, w)));
+    FragColor = vec4(clamp(sharpened, lo, hi), 1.0);
+}
@@ -0,0 +1,150 @@
+// analysis_jobs.cpp - Bifurcation sweep and Lyapunov exponent coroutines
+#include "analysis_jobs.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "lorenz_solver.h"
+
+namespace {
+
+// Payloads are plain arrays in native layout: the cache is per machine
+void append(std::vector<char>& out, const void* data, size_t bytes) {
+    const char* p = static_cast<const char*>(data);
+    out.insert(out.end(), p, p + bytes);
+}
+
+} // namespace
+
+CacheKey cacheKey(const BifurcationSettings& settings) {
+    CacheKey key("bifurcation/v2");
+    key.add("lorenz").add("rk4");
+    key.add(settings.sigma).add(settings.beta).add(settings.rho_min).add(settings.rho_max);
+    key.add(settings.start.x).add(settings.start.y).add(settings.start.z);
+    key.add(settings.dt).add(settings.columns).add(static_cast<double>(settings.transient_steps));
+    key.add(settings.maxima_per_column);
+    return key;
+}
+
+CacheKey cacheKey(const LyapunovSettings& settings) {
+    CacheKey key("lyapunov/v1");
+    key.add("lorenz").add("rk4");
+    key.add(settings.params.sigma).add(settings.params.rho).add(settings.params.beta);
+    key.add(settings.start.x).add(settings.start.y).add(settings.start.z);
+    key.add(settings.dt).add(static_cast<double>(settings.steps)).add(settings.renormalize);
+    key.add(settings.separation);
+    return key;
+}
+
+bool loadCached(ResultCache& cache, const BifurcationSettings& settings, Published<BifurcationResult>& out) {
+    ResultCache::Blob blob = cache.load(cacheKey(settings));
+    if (!blob || blob.size() % sizeof(glm::vec2) != 0) return false;
+    BifurcationResult result;
+    result.settings = settings;
+    const glm::vec2* points = static_cast<const glm::vec2*>(blob.data());
+    result.points.assign(points, points + blob.size() / sizeof(glm::vec2));
+    out.publish(std::move(result));
+    return true;
+}
+
+bool loadCached(ResultCache& cache, const LyapunovSettings& settings, Published<LyapunovResult>& out) {
+    ResultCache::Blob blob = cache.load(cacheKey(settings));
+    if (!blob || blob.size() < sizeof(double) || (blob.size() - sizeof(double)) % sizeof(float) != 0) {
+        return false;
+    }
+    LyapunovResult result;
+    result.settings = settings;
+    const char* data = static_cast<const char*>(blob.data());
+    std::memcpy(&result.exponent, data, sizeof(double));
+    const float* convergence = reinterpret_cast<const float*>(data + sizeof(double));
+    result.convergence.assign(convergence, convergence + (blob.size() - sizeof(double)) / sizeof(float));
+    out.publish(std::move(result));
+    return true;
+}
+
+float bifurcationRho(const BifurcationSettings& settings, int column) {
+    return settings.rho_min + (settings.rho_max - settings.rho_min) * column / std::max(1, settings.columns - 1);
+}
+
+void bifurcationColumn(const BifurcationSettings& settings, int column, std::vector<float>& maxima) {
+    maxima.clear();
+    LorenzSolver solver(settings.sigma, bifurcationRho(settings, column), settings.beta);
+    glm::vec3 state = solver.integrate(settings.start, settings.dt, settings.transient_steps);
+
+    glm::vec3 prev = state, prev2 = state;
+    for (long s = 0; static_cast<int>(maxima.size()) < settings.maxima_per_column &&
+                     s < 64 * settings.transient_steps; ++s) {
+        prev2 = prev;
+        prev = state;
+        state = solver.rk4Step(state, settings.dt);
+        if (prev.z > prev2.z && prev.z >= state.z) maxima.push_back(prev.z);
+    }
+}
+
+void bifurcationChunk(const BifurcationSettings& settings, int first, int count,
+                      std::vector<std::vector<float>>& maxima) {
+    maxima.assign(count, std::vector<float>());
+    for (int i = 0; i < count; ++i) {
+        bifurcationColumn(settings, first + i, maxima[i]);
+    }
+}
+
+Job bifurcationSweep(JobContext& ctx, BifurcationSettings settings, Published<BifurcationResult>& out,
+                     ResultCache* cache) {
+    BifurcationResult result;
+    result.settings = settings;
+    result.points.reserve(static_cast<size_t>(settings.columns) * settings.maxima_per_column);
+
+    // A column is ~10k steps, so yielding per column overruns a slice by well under a ms
+    std::vector<float> maxima;
+    for (int c = 0; c < settings.columns; ++c) {
+        float rho = bifurcationRho(settings, c);
+        bifurcationColumn(settings, c, maxima);
+        for (float z : maxima) result.points.emplace_back(rho, z);
+        ctx.setProgress(static_cast<float>(c + 1) / settings.columns);
+        co_await ctx.yield();
+    }
+    if (cache) {
+        cache->store(cacheKey(settings), result.points.data(), result.points.size() * sizeof(glm::vec2));
+    }
+    out.publish(std::move(result));
+}
+
+Job largestLyapunov(JobContext& ctx, LyapunovSettings settings, Published<LyapunovResult>& out,
+                    ResultCache* cache) {
+    LyapunovResult result;
+    result.settings = settings;
+
+    const LorenzParams& p = settings.params;
+    LorenzSolver solver(p.sigma, p.rho, p.beta);
+    glm::vec3 a = settings.start;
+    glm::vec3 b = a + glm::vec3(settings.separation, 0.0f, 0.0f);
+    double log_sum = 0.0;
+    long samples_every = std::max<long>(settings.steps / 256, settings.renormalize);
+
+    for (long s = 1; s <= settings.steps; ++s) {
+        a = solver.rk4Step(a, settings.dt);
+        b = solver.rk4Step(b, settings.dt);
+        if (s % settings.renormalize == 0) {
+            glm::vec3 offset = b - a;
+            float distance = glm::length(offset);
+            if (distance > 0.0f) {
+                log_sum += std::log(distance / settings.separation);
+                b = a + offset * (settings.separation / distance);
+            }
+        }
+        if (s % samples_every == 0) {
+            result.convergence.push_back(static_cast<float>(log_sum / (s * static_cast<double>(settings.dt))));
+            ctx.setProgress(static_cast<float>(s) / settings.steps);
+        }
+        if (s % 1024 == 0) co_await ctx.yield();
+    }
+    result.exponent = log_sum / (settings.steps * static_cast<double>(settings.dt));
+    if (cache) {
+        std::vector<char> payload;
+        append(payload, &result.exponent, sizeof(double));
+        append(payload, result.convergence.data(), result.convergence.size() * sizeof(float));
+        cache->store(cacheKey(settings), payload.data(), payload.size());
+    }
+    out.publish(std::move(result));
+}
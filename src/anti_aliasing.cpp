@@ -0,0 +1,39 @@
+// anti_aliasing.cpp - Anti-aliasing modes implementation
+#include "anti_aliasing.h"
+#include <algorithm>
+
+AntiAliasing::AntiAliasing()
+    : fxaa_("shaders/fxaa.frag")
+    , output_({GL_RGBA8}, false)
+{
+    glGetIntegerv(GL_MAX_SAMPLES, &max_samples_);
+}
+
+int AntiAliasing::sceneSamples() const {
+    if (mode != AaMode::Msaa || max_samples_ < 2) return 0;
+    return std::clamp(msaa_samples, 2, max_samples_);
+}
+
+void AntiAliasing::apply(GLuint source_texture, GLuint destination, int width, int height) const {
+    glBindFramebuffer(GL_FRAMEBUFFER, destination);
+    glViewport(0, 0, width, height);
+    glDisable(GL_BLEND);
+    fxaa_.drawTexture(source_texture, "source");
+    glEnable(GL_BLEND);
+}
+
+GLuint AntiAliasing::outputTarget(int width, int height) {
+    output_.resize(width, height);
+    return output_.id();
+}
+
+const char* AntiAliasing::modeName(AaMode mode) {
+    switch (mode) {
+        case AaMode::None:          return "None";
+        case AaMode::Msaa:          return "MSAA";
+        case AaMode::Fxaa:          return "FXAA";
+        case AaMode::AnalyticLines: return "Analytic lines";
+        case AaMode::Count:         break;
+    }
+    return "unknown";
+}
@@ -0,0 +1,72 @@
+// bloom.cpp - Dual-filter bloom implementation
+#include "bloom.h"
+#include <algorithm>
+
+Bloom::Bloom()
+    : output_({GL_RGBA8}, false)
+    , downsample_("shaders/bloom_down.frag")
+    , upsample_("shaders/bloom_up.frag")
+    , composite_("shaders/bloom_composite.frag")
+{
+}
+
+void Bloom::resizeChain(int width, int height) {
+    int count = std::clamp(levels, 1, 8) + 1;
+    if (width == chain_width_ && height == chain_height_ && static_cast<int>(mips_.size()) == count) return;
+    chain_width_ = width;
+    chain_height_ = height;
+
+    mips_.clear();
+    int w = width, h = height;
+    for (int i = 0; i < count; ++i) {
+        w = std::max(1, w / 2);
+        h = std::max(1, h / 2);
+        mips_.push_back(std::make_unique<Framebuffer>(std::vector<GLenum>{GL_RGBA16F}, false));
+        mips_.back()->resize(w, h);
+    }
+}
+
+GLuint Bloom::outputTarget(int width, int height) {
+    output_.resize(width, height);
+    return output_.id();
+}
+
+void Bloom::apply(GLuint scene_texture, GLuint destination, int width, int height) {
+    timer_.begin();
+    resizeChain(width, height);
+    glDisable(GL_BLEND);
+
+    // Down: threshold into level 0, then halve
+    GLuint source = scene_texture;
+    int source_w = width, source_h = height;
+    for (size_t i = 0; i < mips_.size(); ++i) {
+        mips_[i]->bind();
+        const Shader& shader = downsample_.use();
+        shader.setVec2("texel", 1.0f / source_w, 1.0f / source_h);
+        shader.setFloat("threshold", i == 0 ? threshold : -1.0f);
+        downsample_.drawTexture(source, "source");
+        source = mips_[i]->colorTexture();
+        source_w = mips_[i]->width();
+        source_h = mips_[i]->height();
+    }
+
+    // Up: each level is replaced by the tent-filtered level below it
+    for (size_t i = mips_.size() - 1; i > 0; --i) {
+        mips_[i - 1]->bind();
+        const Shader& shader = upsample_.use();
+        shader.setVec2("halfTexel", 0.5f / mips_[i]->width(), 0.5f / mips_[i]->height());
+        upsample_.drawTexture(mips_[i]->colorTexture(), "source");
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, destination);
+    glViewport(0, 0, width, height);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, mips_[0]->colorTexture());
+    const Shader& shader = composite_.use();
+    shader.setInt("bloom", 1);
+    shader.setFloat("intensity", intensity);
+    composite_.drawTexture(scene_texture, "scene");
+
+    glEnable(GL_BLEND);
+    timer_.end();
+}
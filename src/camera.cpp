@@ -50,11 +50,15 @@ void Camera::rotate(float delta_yaw, float delta_pitch) {
     // Wrap yaw
     if (yaw > 360.0f) yaw -= 360.0f;
     if (yaw < 0.0f) yaw += 360.0f;
+    
+    revision++;
 }
 
 void Camera::zoom(float delta) {
     distance += delta;
     distance = std::clamp(distance, 5.0f, 200.0f);
+    
+    revision++;
 }
 
 void Camera::pan(float delta_x, float delta_y) {
@@ -67,6 +71,8 @@ void Camera::pan(float delta_x, float delta_y) {
     float pan_speed = distance * 0.01f;
     target += right * delta_x * pan_speed;
     target += up * delta_y * pan_speed;
+    
+    revision++;
 }
 
 void Camera::reset() {
@@ -74,4 +80,6 @@ void Camera::reset() {
     yaw = default_yaw;
     pitch = default_pitch;
     target = default_target;
+    
+    revision++;
 }
\ No newline at end of file
@@ -0,0 +1,144 @@
+// dust_cloud.cpp - Ensemble stepping with direct writes into mapped GPU memory
+#include "dust_cloud.h"
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+#include "memory_tracker.h"
+
+DustCloud::DustCloud(WorkerPool& pool)
+    : pool_(pool)
+{
+    persistent_ = GLAD_GL_VERSION_4_4 || GLAD_GL_ARB_buffer_storage;
+    if (!persistent_) {
+        std::cout << "GL_ARB_buffer_storage unavailable; dust uploads with glBufferSubData" << std::endl;
+    }
+}
+
+DustCloud::~DustCloud() {
+    release();
+}
+
+void DustCloud::release() {
+    for (int r = 0; r < kRegions; ++r) {
+        waitRegion(r);
+    }
+    if (vbo_) {
+        if (mapped_) {
+            glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+            mapped_ = nullptr;
+        }
+        glDeleteBuffers(1, &vbo_);
+        glDeleteVertexArrays(kRegions, vaos_);
+        memory::sub(MemTag::GpuBuffers, kRegions * region_bytes_);
+        vbo_ = 0;
+    }
+    region_bytes_ = 0;
+    draw_region_ = -1;
+    ensemble_.reset();
+}
+
+void DustCloud::allocate(size_t count) {
+    release();
+    ensemble_.reset(new Ensemble(count, pool_));
+
+    // Each region is three float arrays (x, y, z), mirroring the ensemble
+    region_bytes_ = 3 * count * sizeof(float);
+    GLsizeiptr bytes = static_cast<GLsizeiptr>(kRegions * region_bytes_);
+    glGenBuffers(1, &vbo_);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+    if (persistent_) {
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(GL_ARRAY_BUFFER, bytes, nullptr, flags);
+        mapped_ = static_cast<float*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, bytes, flags));
+        if (!mapped_) {
+            std::cerr << "Failed to map dust buffer; falling back to glBufferSubData" << std::endl;
+            persistent_ = false;
+            glDeleteBuffers(1, &vbo_);
+            glGenBuffers(1, &vbo_);
+            glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+        }
+    }
+    if (!persistent_) {
+        glBufferData(GL_ARRAY_BUFFER, bytes, nullptr, GL_STREAM_DRAW);
+    }
+    memory::add(MemTag::GpuBuffers, bytes);
+
+    glGenVertexArrays(kRegions, vaos_);
+    for (int r = 0; r < kRegions; ++r) {
+        glBindVertexArray(vaos_[r]);
+        for (GLuint axis = 0; axis < 3; ++axis) {
+            size_t offset = r * region_bytes_ + axis * count * sizeof(float);
+            glVertexAttribPointer(axis, 1, GL_FLOAT, GL_FALSE, sizeof(float), (void*)offset);
+            glEnableVertexAttribArray(axis);
+        }
+    }
+    glBindVertexArray(0);
+}
+
+void DustCloud::waitRegion(int region) {
+    GLsync& fence = fences_[region];
+    if (!fence) return;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (;;) {
+        GLenum status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);  // 1 ms
+        if (status != GL_TIMEOUT_EXPIRED) break;   // Signalled, or failed (nothing to wait for)
+    }
+    glDeleteSync(fence);
+    fence = nullptr;
+    fence_wait_ms_ += std::chrono::duration<double, std::milli>(
+        std::chrono::high_resolution_clock::now() - start).count();
+}
+
+void DustCloud::stream(const LorenzParams& params, float dt, long steps) {
+    int region = write_region_;
+    fence_wait_ms_ = 0.0;
+    waitRegion(region);
+
+    size_t count = ensemble_->size();
+    if (persistent_) {
+        // Workers publish their own slices straight into the mapping
+        float* base = mapped_ + region * region_bytes_ / sizeof(float);
+        const Ensemble& cloud = *ensemble_;
+        ensemble_->step(params, dt, steps, [&](size_t begin, size_t end) {
+            size_t bytes = (end - begin) * sizeof(float);
+            std::memcpy(base + begin, cloud.x() + begin, bytes);
+            std::memcpy(base + count + begin, cloud.y() + begin, bytes);
+            std::memcpy(base + 2 * count + begin, cloud.z() + begin, bytes);
+        });
+    } else {
+        ensemble_->step(params, dt, steps);
+        size_t bytes = count * sizeof(float);
+        GLintptr offset = static_cast<GLintptr>(region * region_bytes_);
+        glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+        glBufferSubData(GL_ARRAY_BUFFER, offset, bytes, ensemble_->x());
+        glBufferSubData(GL_ARRAY_BUFFER, offset + bytes, bytes, ensemble_->y());
+        glBufferSubData(GL_ARRAY_BUFFER, offset + 2 * bytes, bytes, ensemble_->z());
+    }
+
+    draw_region_ = region;
+    write_region_ = (region + 1) % kRegions;
+}
+
+void DustCloud::seed(size_t count, const glm::vec3& center, float radius) {
+    if (count != size()) allocate(count);
+    ensemble_->seedBall(center, radius);
+    stream(LorenzParams{}, 0.0f, 0);   // Zero steps: publish the seeds as they are
+}
+
+void DustCloud::advance(const LorenzParams& params, float dt, long steps) {
+    if (!ensemble_) return;
+    stream(params, dt, steps);
+}
+
+void DustCloud::draw() {
+    if (draw_region_ < 0) return;
+    glBindVertexArray(vaos_[draw_region_]);
+    glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(size()));
+    glBindVertexArray(0);
+
+    // The next write to this region waits until the GPU has read it
+    if (fences_[draw_region_]) glDeleteSync(fences_[draw_region_]);
+    fences_[draw_region_] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
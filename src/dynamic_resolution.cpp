@@ -0,0 +1,69 @@
+// dynamic_resolution.cpp - Resolution scaling controller and upscale pass
+#include "dynamic_resolution.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr float kStep = 0.05f;     // Scale granularity
+constexpr int kCooldown = 15;      // Frames between changes (> timer latency)
+
+} // namespace
+
+DynamicResolution::DynamicResolution()
+    : scene_({GL_RGBA8}, false)
+    , upscale_("shaders/upscale.frag")
+{
+}
+
+int DynamicResolution::sceneWidth(int width) const {
+    return active() ? std::max(1, static_cast<int>(width * scale_ + 0.5f)) : width;
+}
+
+int DynamicResolution::sceneHeight(int height) const {
+    return active() ? std::max(1, static_cast<int>(height * scale_ + 0.5f)) : height;
+}
+
+GLuint DynamicResolution::sceneTarget(int width, int height) {
+    scene_.resize(sceneWidth(width), sceneHeight(height));
+    return scene_.id();
+}
+
+void DynamicResolution::present(GLuint texture, int width, int height) {
+    Framebuffer::bindDefault(width, height);
+    if (!scene_.valid()) return;
+
+    glDisable(GL_BLEND);
+    const Shader& shader = upscale_.use();
+    shader.setFloat("sharpness", sharpness);
+    upscale_.drawTexture(texture, "source");
+    glEnable(GL_BLEND);
+}
+
+void DynamicResolution::update(double gpu_ms) {
+    float floor_scale = std::clamp(min_scale, 0.25f, 1.0f);
+    if (!enabled) {
+        scale_ = 1.0f;
+        return;
+    }
+    if (scale_ < floor_scale) scale_ = floor_scale;
+    if (cooldown_ > 0) {
+        --cooldown_;
+        return;
+    }
+
+    // Pixel cost goes with area, so aim for the scale whose area fits the
+    // budget; shrink quickly, grow back only with clear headroom
+    float next = scale_;
+    if (gpu_ms > target_ms) {
+        next = scale_ * std::sqrt(static_cast<float>(target_ms / gpu_ms));
+        next = std::min(next, scale_ - kStep);
+    } else if (gpu_ms < 0.7 * target_ms && scale_ < 1.0f) {
+        next = scale_ + kStep;
+    }
+    next = std::clamp(std::round(next / kStep) * kStep, floor_scale, 1.0f);
+    if (next != scale_) {
+        scale_ = next;
+        cooldown_ = kCooldown;
+    }
+}
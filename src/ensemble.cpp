@@ -0,0 +1,91 @@
+// ensemble.cpp - Structure-of-arrays Lorenz ensemble implementation
+#include "ensemble.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <new>
+
+#include "memory_tracker.h"
+
+Ensemble::Ensemble(size_t count, WorkerPool& pool, bool explicit_huge)
+    : count_(count)
+    , capacity_bytes_(std::max<size_t>(count, 1) * sizeof(float))
+    , pool_(pool)
+{
+    PageBacking bx, by, bz;
+    x_ = static_cast<float*>(huge_alloc(capacity_bytes_, explicit_huge, &bx));
+    y_ = static_cast<float*>(huge_alloc(capacity_bytes_, explicit_huge, &by));
+    z_ = static_cast<float*>(huge_alloc(capacity_bytes_, explicit_huge, &bz));
+    if (!x_ || !y_ || !z_) {
+        huge_free(x_, capacity_bytes_);
+        huge_free(y_, capacity_bytes_);
+        huge_free(z_, capacity_bytes_);
+        throw std::bad_alloc();
+    }
+    backing_ = std::min(bx, std::min(by, bz));
+    memory::add(MemTag::Ensemble, bytes());
+
+    // Whole huge pages per worker when the arrays are big enough, else small pages
+    size_t per_worker = count_ / std::max(1, pool_.size());
+    size_t huge_elems = kHugePageSize / sizeof(float);
+    granularity_ = (backing_ != PageBacking::Small && per_worker >= huge_elems)
+        ? huge_elems : kSmallPageSize / sizeof(float);
+
+    // First touch from the owning worker places each slice on its node
+    pool_.run([this](int worker, int) {
+        size_t begin, end;
+        range(worker, begin, end);
+        std::fill(x_ + begin, x_ + end, 0.0f);
+        std::fill(y_ + begin, y_ + end, 0.0f);
+        std::fill(z_ + begin, z_ + end, 0.0f);
+    });
+}
+
+Ensemble::~Ensemble() {
+    memory::sub(MemTag::Ensemble, bytes());
+    huge_free(x_, capacity_bytes_);
+    huge_free(y_, capacity_bytes_);
+    huge_free(z_, capacity_bytes_);
+}
+
+void Ensemble::range(int worker, size_t& begin, size_t& end) const {
+    WorkerPool::partition(count_, worker, pool_.size(), granularity_, begin, end);
+}
+
+void Ensemble::seedBall(const glm::vec3& center, float radius, unsigned seed) {
+    pool_.run([&](int worker, int) {
+        size_t begin, end;
+        range(worker, begin, end);
+        for (size_t i = begin; i < end; ++i) {
+            // Hash the index so the cloud does not depend on the worker count
+            uint64_t h = (i + 1) * 0x9E3779B97F4A7C15ull ^ (uint64_t(seed) << 32);
+            auto next = [&h]() {
+                h ^= h >> 33; h *= 0xFF51AFD7ED558CCDull; h ^= h >> 33;
+                return (h >> 40) * (1.0f / 16777216.0f);
+            };
+            // Rejection-free: random direction scaled by cbrt for a uniform ball
+            float u = 2.0f * next() - 1.0f;
+            float phi = 6.2831853f * next();
+            float r = radius * std::cbrt(next());
+            float s = std::sqrt(std::max(0.0f, 1.0f - u * u));
+            x_[i] = center.x + r * s * std::cos(phi);
+            y_[i] = center.y + r * s * std::sin(phi);
+            z_[i] = center.z + r * u;
+        }
+    });
+}
+
+void Ensemble::step(const LorenzParams& params, float dt, long steps) {
+    step(params, dt, steps, SliceFn());
+}
+
+void Ensemble::step(const LorenzParams& params, float dt, long steps, const SliceFn& publish) {
+    pool_.run([&](int worker, int) {
+        size_t begin, end;
+        range(worker, begin, end);
+        if (end > begin) {
+            kernels::rk4Batch(x_ + begin, y_ + begin, z_ + begin, end - begin, params, dt, steps);
+            if (publish) publish(begin, end);
+        }
+    });
+}
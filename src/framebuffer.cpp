@@ -0,0 +1,145 @@
+// framebuffer.cpp - Offscreen render target implementation
+#include "framebuffer.h"
+#include <iostream>
+
+#include "memory_tracker.h"
+
+namespace {
+
+size_t bytes_per_pixel(GLenum format) {
+    switch (format) {
+        case GL_R8:                 return 1;
+        case GL_R16F:               return 2;
+        case GL_RG16F:              return 4;
+        case GL_RGBA8:              return 4;
+        case GL_R11F_G11F_B10F:     return 4;
+        case GL_R32F:               return 4;
+        case GL_DEPTH_COMPONENT24:  return 4;
+        case GL_DEPTH_COMPONENT32F: return 4;
+        case GL_RGBA16F:            return 8;
+        case GL_RGBA32F:            return 16;
+        default:                    return 4;
+    }
+}
+
+GLuint make_texture(GLenum format, int width, int height, int samples) {
+    GLuint tex;
+    glGenTextures(1, &tex);
+    if (samples > 0) {
+        glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, tex);
+        glTexImage2DMultisample(GL_TEXTURE_2D_MULTISAMPLE, samples, format, width, height, GL_TRUE);
+        glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, 0);
+    } else {
+        glBindTexture(GL_TEXTURE_2D, tex);
+        glTexStorage2D(GL_TEXTURE_2D, 1, format, width, height);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+    return tex;
+}
+
+} // namespace
+
+Framebuffer::Framebuffer(std::vector<GLenum> color_formats, bool depth, int samples)
+    : color_formats_(std::move(color_formats))
+    , has_depth_(depth)
+    , samples_(samples)
+{
+}
+
+Framebuffer::~Framebuffer() {
+    release();
+}
+
+void Framebuffer::release() {
+    if (!fbo_) return;
+    memory::sub(MemTag::GpuBuffers, bytes());
+    glDeleteFramebuffers(1, &fbo_);
+    glDeleteTextures(static_cast<GLsizei>(color_textures_.size()), color_textures_.data());
+    if (depth_texture_) glDeleteTextures(1, &depth_texture_);
+    fbo_ = 0;
+    depth_texture_ = 0;
+    color_textures_.clear();
+}
+
+void Framebuffer::setSamples(int samples) {
+    if (samples == samples_) return;
+    samples_ = samples;
+    int w = width_, h = height_;
+    release();
+    width_ = height_ = 0;
+    if (w > 0 && h > 0) resize(w, h);
+}
+
+bool Framebuffer::resize(int width, int height) {
+    if (width <= 0 || height <= 0) return false;
+    if (fbo_ && width == width_ && height == height_) return false;
+    release();
+    width_ = width;
+    height_ = height;
+
+    glGenFramebuffers(1, &fbo_);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+    GLenum target = samples_ > 0 ? GL_TEXTURE_2D_MULTISAMPLE : GL_TEXTURE_2D;
+
+    std::vector<GLenum> draw_buffers;
+    for (size_t i = 0; i < color_formats_.size(); ++i) {
+        GLuint tex = make_texture(color_formats_[i], width, height, samples_);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + i, target, tex, 0);
+        color_textures_.push_back(tex);
+        draw_buffers.push_back(GL_COLOR_ATTACHMENT0 + i);
+    }
+    glDrawBuffers(static_cast<GLsizei>(draw_buffers.size()), draw_buffers.data());
+
+    if (has_depth_) {
+        depth_texture_ = make_texture(GL_DEPTH_COMPONENT24, width, height, samples_);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, target, depth_texture_, 0);
+    }
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "ERROR::FRAMEBUFFER:: incomplete (" << width << "x" << height
+                  << ", " << samples_ << " samples)" << std::endl;
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    memory::add(MemTag::GpuBuffers, bytes());
+    return true;
+}
+
+void Framebuffer::bind() const {
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+    glViewport(0, 0, width_, height_);
+}
+
+void Framebuffer::bindDefault(int width, int height) {
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(0, 0, width, height);
+}
+
+void Framebuffer::blitTo(GLuint target, int target_width, int target_height,
+                         GLbitfield mask, GLenum filter) const {
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo_);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, target);
+    glBlitFramebuffer(0, 0, width_, height_, 0, 0, target_width, target_height, mask, filter);
+    glBindFramebuffer(GL_FRAMEBUFFER, target);
+}
+
+void Framebuffer::copyFrom(GLuint source, int source_width, int source_height) const {
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, source);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, fbo_);
+    glBlitFramebuffer(0, 0, source_width, source_height, 0, 0, width_, height_,
+                      GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    glBindFramebuffer(GL_FRAMEBUFFER, source);
+}
+
+size_t Framebuffer::bytes() const {
+    if (!fbo_) return 0;
+    size_t pixels = static_cast<size_t>(width_) * height_ * (samples_ > 0 ? samples_ : 1);
+    size_t total = 0;
+    for (GLenum format : color_formats_) total += pixels * bytes_per_pixel(format);
+    if (has_depth_) total += pixels * bytes_per_pixel(GL_DEPTH_COMPONENT24);
+    return total;
+}
@@ -0,0 +1,34 @@
+// fullscreen_pass.cpp - Full-screen pass implementation
+#include "fullscreen_pass.h"
+
+FullscreenPass::FullscreenPass(const char* fragment_path)
+    : shader_("shaders/fullscreen.vert", fragment_path)
+{
+    // Core profile needs a bound VAO even for attribute-less draws
+    glGenVertexArrays(1, &vao_);
+}
+
+FullscreenPass::~FullscreenPass() {
+    glDeleteVertexArrays(1, &vao_);
+}
+
+const Shader& FullscreenPass::use() const {
+    shader_.use();
+    return shader_;
+}
+
+void FullscreenPass::draw() const {
+    GLboolean depth = glIsEnabled(GL_DEPTH_TEST);
+    glDisable(GL_DEPTH_TEST);
+    glBindVertexArray(vao_);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    glBindVertexArray(0);
+    if (depth) glEnable(GL_DEPTH_TEST);
+}
+
+void FullscreenPass::drawTexture(GLuint texture, const char* sampler) const {
+    use().setInt(sampler, 0);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    draw();
+}
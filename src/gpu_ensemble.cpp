@@ -0,0 +1,136 @@
+// gpu_ensemble.cpp - Compute-shader RK4 ensemble with sampled CPU validation
+#include "gpu_ensemble.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+#include "lorenz_solver.h"
+#include "memory_tracker.h"
+
+namespace {
+
+constexpr GLuint kLocalSize = 256;   // local_size_x in ensemble.comp
+
+} // namespace
+
+GpuEnsemble::GpuEnsemble() {
+    if (!GLAD_GL_VERSION_4_3) {
+        std::cout << "OpenGL 4.3 unavailable; no compute-shader ensemble" << std::endl;
+        return;
+    }
+    ShaderSources sources;
+    sources.compute = "shaders/ensemble.comp";
+    program_.reset(new Shader(sources));
+    available_ = program_->isLinked();
+    if (!available_) return;
+
+    glGenBuffers(1, &ssbo_);
+    glGenVertexArrays(1, &vao_);
+}
+
+GpuEnsemble::~GpuEnsemble() {
+    memory::sub(MemTag::GpuBuffers, count_ * sizeof(glm::vec4));
+    glDeleteBuffers(1, &ssbo_);
+    glDeleteVertexArrays(1, &vao_);
+}
+
+void GpuEnsemble::seed(size_t count, const glm::vec3& center, float radius, unsigned seed) {
+    if (!available_) return;
+
+    // One work group per 256 particles, within the guaranteed 65535 groups
+    count = std::min<size_t>(count, size_t(65535) * kLocalSize);
+    if (count != count_) {
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, ssbo_);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, count * sizeof(glm::vec4), nullptr, GL_DYNAMIC_COPY);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+        memory::replace(MemTag::GpuBuffers, count_ * sizeof(glm::vec4), count * sizeof(glm::vec4));
+        count_ = count;
+
+        // x, y, z as separate float attributes, like the CPU dust cloud
+        glBindVertexArray(vao_);
+        glBindBuffer(GL_ARRAY_BUFFER, ssbo_);
+        for (GLuint axis = 0; axis < 3; ++axis) {
+            glVertexAttribPointer(axis, 1, GL_FLOAT, GL_FALSE, sizeof(glm::vec4),
+                                  (void*)(axis * sizeof(float)));
+            glEnableVertexAttribArray(axis);
+        }
+        glBindVertexArray(0);
+    }
+
+    program_->use();
+    program_->setBool("seeding", true);
+    program_->setVec3("center", center.x, center.y, center.z);
+    program_->setFloat("radius", radius);
+    glUniform1ui(glGetUniformLocation(program_->ID, "seed"), seed);
+    dispatch();
+    advances_ = 0;
+}
+
+void GpuEnsemble::dispatch() {
+    glUniform1ui(glGetUniformLocation(program_->ID, "count"), static_cast<GLuint>(count_));
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, ssbo_);
+    glDispatchCompute(static_cast<GLuint>((count_ + kLocalSize - 1) / kLocalSize), 1, 1);
+
+    // Later reads are vertex fetches and (for the cross-check) buffer reads
+    glMemoryBarrier(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+}
+
+void GpuEnsemble::readSamples(std::vector<glm::vec3>& out) {
+    size_t samples = std::min<size_t>(check_samples, count_);
+    out.resize(samples);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, ssbo_);
+    for (size_t s = 0; s < samples; ++s) {
+        size_t index = s * count_ / samples;
+        glm::vec4 state;
+        glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, index * sizeof(glm::vec4), sizeof(state), &state);
+        out[s] = glm::vec3(state.x, state.y, state.z);
+    }
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+void GpuEnsemble::advance(const LorenzParams& params, float dt, long steps) {
+    if (!available_ || count_ == 0 || steps <= 0) return;
+
+    // Read-backs stall the pipeline, so only every check_interval-th advance validates
+    bool check = check_interval > 0 && advances_ % check_interval == 0;
+    ++advances_;
+    std::vector<glm::vec3> before, after;
+    if (check) readSamples(before);
+
+    program_->use();
+    program_->setBool("seeding", false);
+    program_->setFloat("sigma", params.sigma);
+    program_->setFloat("rho", params.rho);
+    program_->setFloat("beta", params.beta);
+    program_->setFloat("dt", dt);
+    program_->setInt("steps", static_cast<int>(steps));
+    dispatch();
+
+    if (!check) return;
+    readSamples(after);
+
+    // Operation order matches, but the GPU may contract to FMA; over one
+    // frame's steps that stays far below the tolerance
+    LorenzSolver reference(params.sigma, params.rho, params.beta);
+    float worst = 0.0f;
+    for (size_t s = 0; s < before.size(); ++s) {
+        glm::vec3 expected = reference.integrate(before[s], dt, steps);
+        float error = glm::length(after[s] - expected) / std::max(1.0f, glm::length(expected));
+        if (!(error <= worst)) worst = error;   // Also catches NaN
+    }
+    stats_.checks++;
+    stats_.last_error = worst;
+    stats_.max_error = std::max(stats_.max_error, worst);
+    if (!(worst <= tolerance)) {
+        stats_.failures++;
+        std::cerr << "Compute ensemble cross-check failed: relative error " << worst
+                  << " > " << tolerance << std::endl;
+    }
+}
+
+void GpuEnsemble::draw() {
+    if (!available_ || count_ == 0) return;
+    glBindVertexArray(vao_);
+    glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(count_));
+    glBindVertexArray(0);
+}
@@ -0,0 +1,50 @@
+// gpu_timer.cpp - GPU timer query ring implementation
+#include "gpu_timer.h"
+
+GpuTimer::GpuTimer(int latency)
+    : queries_(latency > 1 ? latency : 2, 0)
+    , pending_(queries_.size(), false)
+{
+    glGenQueries(static_cast<GLsizei>(queries_.size()), queries_.data());
+}
+
+GpuTimer::~GpuTimer() {
+    glDeleteQueries(static_cast<GLsizei>(queries_.size()), queries_.data());
+}
+
+void GpuTimer::collect() {
+    // Queries complete in submission order, so stop at the first unfinished one
+    while (pending_[oldest_]) {
+        GLint available = 0;
+        glGetQueryObjectiv(queries_[oldest_], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) break;
+
+        GLuint64 ns = 0;
+        glGetQueryObjectui64v(queries_[oldest_], GL_QUERY_RESULT, &ns);
+        pending_[oldest_] = false;
+        oldest_ = (oldest_ + 1) % static_cast<int>(queries_.size());
+
+        last_ms_ = ns / 1.0e6;
+        average_ms_ = samples_ ? average_ms_ + 0.1 * (last_ms_ - average_ms_) : last_ms_;
+        ++samples_;
+    }
+}
+
+void GpuTimer::begin() {
+    collect();
+    active_ = !pending_[next_];
+    if (active_) glBeginQuery(GL_TIME_ELAPSED, queries_[next_]);
+}
+
+void GpuTimer::end() {
+    if (!active_) return;
+    glEndQuery(GL_TIME_ELAPSED);
+    pending_[next_] = true;
+    next_ = (next_ + 1) % static_cast<int>(queries_.size());
+    active_ = false;
+}
+
+void GpuTimer::reset() {
+    last_ms_ = average_ms_ = 0.0;
+    samples_ = 0;
+}
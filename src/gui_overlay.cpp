@@ -0,0 +1,54 @@
+// gui_overlay.cpp - Cached GUI overlay implementation
+#include "gui_overlay.h"
+
+namespace {
+
+// Input, then this many extra rebuilds: clicks resolve a frame after release
+constexpr int kSettleFrames = 2;
+
+} // namespace
+
+GuiOverlay::GuiOverlay()
+    : target_({GL_RGBA8}, false)
+    , pass_("shaders/overlay.frag")
+{
+}
+
+void GuiOverlay::resize(int width, int height) {
+    width_ = width;
+    height_ = height;
+    if (enabled && target_.resize(width, height)) dirty_ = true;
+}
+
+void GuiOverlay::markInput() {
+    settle_frames_ = kSettleFrames + 1;
+}
+
+bool GuiOverlay::needsRebuild(double now, uint64_t signature) const {
+    return !enabled || dirty_ || settle_frames_ > 0 || signature != last_signature_ ||
+           now - last_rebuild_ >= refresh_interval;
+}
+
+void GuiOverlay::beginRebuild() {
+    if (!enabled) return;
+    target_.resize(width_, height_);
+    target_.bind();
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+}
+
+void GuiOverlay::endRebuild(double now, uint64_t signature) {
+    if (settle_frames_ > 0) --settle_frames_;
+    dirty_ = false;
+    last_rebuild_ = now;
+    last_signature_ = signature;
+    if (enabled) Framebuffer::bindDefault(width_, height_);
+}
+
+void GuiOverlay::composite() {
+    if (!enabled || !target_.valid()) return;
+
+    glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+    pass_.drawTexture(target_.colorTexture(), "overlay");
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+}
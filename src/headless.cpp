@@ -0,0 +1,457 @@
+// headless.cpp - Command-line modes that run without opening a window
+#include "headless.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ensemble.h"
+#include "hdr_histogram.h"
+#include "kernels.h"
+#include "lorenz_solver.h"
+#include "memory_tracker.h"
+#include "metrics.h"
+#include "metrics_server.h"
+#include "parareal.h"
+#include "profiler.h"
+#include "trajectory_stream.h"
+#include "trajectory_writer.h"
+
+namespace {
+
+const char* arg_value(int argc, char** argv, const char* name) {
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::strcmp(argv[i], name) == 0) return argv[i + 1];
+    }
+    return nullptr;
+}
+
+using Clock = std::chrono::high_resolution_clock;
+
+double seconds_since(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+volatile std::sig_atomic_t g_interrupted = 0;
+
+void on_interrupt(int) {
+    g_interrupted = 1;
+}
+
+// Enough to resume a run bit-exactly: step count, state, parameters and dt
+struct Checkpoint {
+    char magic[8] = {'L', 'O', 'R', 'E', 'N', 'Z', 'C', '1'};
+    uint64_t steps = 0;
+    float state[3] = {0.0f, 0.0f, 0.0f};
+    LorenzParams params{10.0f, 28.0f, 8.0f / 3.0f};
+    float dt = 0.0f;
+};
+
+bool write_checkpoint(const std::string& path, const Checkpoint& cp) {
+    // Write-then-rename so a crash never leaves a torn checkpoint behind
+    std::string tmp = path + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (!out.write(reinterpret_cast<const char*>(&cp), sizeof(cp))) return false;
+    }
+    return std::rename(tmp.c_str(), path.c_str()) == 0;
+}
+
+bool read_checkpoint(const std::string& path, Checkpoint& cp) {
+    std::ifstream in(path, std::ios::binary);
+    Checkpoint loaded;
+    if (!in.read(reinterpret_cast<char*>(&loaded), sizeof(loaded))) return false;
+    if (std::memcmp(loaded.magic, cp.magic, sizeof(cp.magic)) != 0) return false;
+    cp = loaded;
+    return true;
+}
+
+} // namespace
+
+bool has_flag(int argc, char** argv, const char* flag) {
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], flag) == 0) return true;
+    }
+    return false;
+}
+
+int arg_int(int argc, char** argv, const char* name, int fallback) {
+    const char* value = arg_value(argc, argv, name);
+    return value ? std::atoi(value) : fallback;
+}
+
+long long arg_long(int argc, char** argv, const char* name, long long fallback) {
+    const char* value = arg_value(argc, argv, name);
+    return value ? std::atoll(value) : fallback;
+}
+
+float arg_float(int argc, char** argv, const char* name, float fallback) {
+    const char* value = arg_value(argc, argv, name);
+    return value ? static_cast<float>(std::atof(value)) : fallback;
+}
+
+const char* arg_string(int argc, char** argv, const char* name, const char* fallback) {
+    const char* value = arg_value(argc, argv, name);
+    return value ? value : fallback;
+}
+
+int run_parareal(int argc, char** argv) {
+    PararealConfig config;
+    config.t_end = arg_float(argc, argv, "--t-end", config.t_end);
+    config.fine_dt = arg_float(argc, argv, "--dt", config.fine_dt);
+    config.coarse_dt = arg_float(argc, argv, "--coarse-dt", config.coarse_dt);
+    config.slices = arg_int(argc, argv, "--slices", config.slices);
+    config.max_iterations = arg_int(argc, argv, "--iterations", config.max_iterations);
+    config.tolerance = arg_float(argc, argv, "--tol", config.tolerance);
+    config.threads = arg_int(argc, argv, "--threads", config.threads);
+
+    if (config.t_end <= 0.0f || config.fine_dt <= 0.0f || config.coarse_dt < config.fine_dt) {
+        std::cerr << "Invalid Parareal setup: need t_end > 0 and coarse_dt >= dt > 0" << std::endl;
+        return -1;
+    }
+
+    LorenzSolver solver;
+    Parareal parareal(solver, config);
+    PararealResult result = parareal.run(glm::vec3(0.0f, 1.0f, 0.0f));
+
+    std::cout << "\n=== Parareal Reference Run ===" << std::endl;
+    std::cout << "Time span:   " << config.t_end << " in " << config.slices << " slices" << std::endl;
+    std::cout << "Iterations:  " << result.iterations
+              << (result.converged ? " (converged)" : " (NOT converged)") << std::endl;
+    for (size_t k = 0; k < result.iteration_updates.size(); ++k) {
+        std::cout << "  k=" << std::setw(2) << k + 1 << "  max update "
+                  << std::scientific << std::setprecision(3)
+                  << result.iteration_updates[k] << std::defaultfloat << std::endl;
+    }
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Serial:      " << result.serial_seconds * 1000.0 << " ms" << std::endl;
+    std::cout << "Parareal:    " << result.parareal_seconds * 1000.0 << " ms" << std::endl;
+    std::cout << "Speedup:     " << result.speedup << "x" << std::endl;
+    std::cout << "Final error: " << std::scientific << result.error_vs_serial
+              << " vs serial fine run" << std::fixed << std::endl;
+    std::cout << "Lyapunov:    " << result.lyapunov_exponent << std::endl;
+    if (std::isfinite(result.horizon)) {
+        std::cout << "Horizon:     " << result.horizon << " time units at tol "
+                  << std::scientific << config.tolerance << std::fixed << std::endl;
+        if (config.t_end > result.horizon) {
+            std::cout << "WARNING: t_end exceeds the predictability horizon. Rounding and coarse"
+                      << " errors grow exponentially,\n         so convergence needs ~slices"
+                      << " iterations and gives no speedup." << std::endl;
+        }
+    } else {
+        std::cout << "Horizon:     unbounded (non-chaotic parameters)" << std::endl;
+    }
+    std::cout << "==============================\n" << std::endl;
+
+    return result.converged ? 0 : 1;
+}
+
+int run_benchmark(int argc, char** argv) {
+    const int particles = std::max(1, arg_int(argc, argv, "--particles", 65536));
+    const int steps = std::max(1, arg_int(argc, argv, "--steps", 200));
+    const float dt = arg_float(argc, argv, "--dt", 0.01f);
+
+    LorenzSolver solver;
+    const LorenzParams params = solver.getParameters();
+    const SimdPath chosen = kernels::activePath();
+    Profiler& profiler = Profiler::instance();
+    profiler.enableCounters(has_flag(argc, argv, "--counters"));
+
+    // Single trajectory through the scalar solver (the interactive path)
+    const long solver_steps = static_cast<long>(particles) * steps / 16;
+    auto start = Clock::now();
+    glm::vec3 end_state;
+    {
+        PROFILE_ZONE("solver", solver_steps);
+        end_state = solver.integrate(solver.getState(), dt, solver_steps);
+    }
+    double solver_rate = solver_steps / seconds_since(start);
+
+    // Same trajectory through the lazy stream; the adaptors should fuse away
+    start = Clock::now();
+    glm::vec3 stream_sum(0.0f);
+    {
+        PROFILE_ZONE("stream", solver_steps);
+        for (const glm::vec3& p : solver.stream(dt) | stream::every(16) | stream::take(solver_steps / 16)) {
+            stream_sum += p;
+        }
+    }
+    double stream_rate = solver_steps / seconds_since(start);
+
+    std::cout << "{\n";
+    std::cout << "  \"simd_path\": \"" << kernels::pathName(chosen) << "\",\n";
+    std::cout << "  \"particles\": " << particles << ",\n";
+    std::cout << "  \"steps\": " << steps << ",\n";
+    std::cout << "  \"solver_steps_per_sec\": " << std::fixed << std::setprecision(0)
+              << solver_rate << ",\n";
+    std::cout << "  \"stream_steps_per_sec\": " << stream_rate << ", \"stream_checksum\": "
+              << std::setprecision(6) << (stream_sum.x + stream_sum.y + stream_sum.z)
+              << std::setprecision(0) << ",\n";
+    std::cout << "  \"kernels\": [";
+
+    // Batched kernel on each path this CPU supports, same initial cloud each time
+    bool first = true;
+    for (SimdPath path : {SimdPath::Scalar, SimdPath::SSE42, SimdPath::AVX2, SimdPath::AVX512}) {
+        if (!kernels::setPath(path)) continue;
+
+        std::vector<float> x(particles), y(particles), z(particles);
+        for (int i = 0; i < particles; ++i) {
+            x[i] = end_state.x + 1e-3f * (i % 97);
+            y[i] = end_state.y + 1e-3f * (i % 89);
+            z[i] = end_state.z + 1e-3f * (i % 83);
+        }
+
+        std::string zone = std::string("rk4_batch_") + kernels::pathName(path);
+        start = Clock::now();
+        {
+            PROFILE_ZONE(zone.c_str(), static_cast<uint64_t>(particles) * steps);
+            kernels::rk4Batch(x.data(), y.data(), z.data(), particles, params, dt, steps);
+        }
+        double seconds = seconds_since(start);
+
+        std::cout << (first ? "\n" : ",\n");
+        std::cout << "    {\"path\": \"" << kernels::pathName(path) << "\", "
+                  << "\"steps_per_sec\": " << std::setprecision(0)
+                  << static_cast<double>(particles) * steps / seconds << ", "
+                  << "\"checksum\": " << std::setprecision(6) << (x[0] + y[0] + z[0]) << "}";
+        first = false;
+    }
+    kernels::setPath(chosen);
+    std::cout << "\n  ],\n";
+
+    // Whole ensemble on pinned workers, arrays first-touched by their owners
+    WorkerPool pool(arg_int(argc, argv, "--threads", 0), !has_flag(argc, argv, "--no-pin"));
+    Ensemble ensemble(particles, pool, has_flag(argc, argv, "--hugetlb"));
+    ensemble.seedBall(end_state, 1.0f);
+    start = Clock::now();
+    {
+        PROFILE_ZONE("ensemble", static_cast<uint64_t>(particles) * steps);
+        ensemble.step(params, dt, steps);
+    }
+    double ensemble_seconds = seconds_since(start);
+
+    std::cout << "  \"ensemble\": {\"threads\": " << pool.size()
+              << ", \"numa_nodes\": " << NumaTopology::get().nodeCount()
+              << ", \"pinned\": " << (pool.pinned() ? "true" : "false")
+              << ", \"pages\": \"" << backing_name(ensemble.backing()) << "\""
+              << ", \"steps_per_sec\": " << std::setprecision(0)
+              << static_cast<double>(particles) * steps / ensemble_seconds << "},\n";
+
+    std::cout << "  \"memory\": {";
+    for (int t = 0; t < static_cast<int>(MemTag::Count); ++t) {
+        MemTag tag = static_cast<MemTag>(t);
+        std::cout << (t ? ", " : "") << "\"" << memory::tagName(tag) << "\": {\"live\": "
+                  << memory::live(tag) << ", \"peak\": " << memory::peak(tag) << "}";
+    }
+    std::cout << "},\n";
+
+    // Zones measure the calling thread only; the ensemble zone excludes its workers
+    std::cout << "  \"counters\": " << (profiler.countersEnabled() && profiler.countersAvailable()
+                                          ? "true" : "false") << ",\n";
+    std::cout << "  \"zones\": [";
+    first = true;
+    for (const ZoneStats& zone : profiler.totals()) {
+        std::cout << (first ? "\n" : ",\n");
+        std::cout << "    {\"name\": \"" << zone.name << "\", \"ms\": " << std::setprecision(3)
+                  << zone.seconds * 1000.0 << ", \"items\": " << zone.items;
+        if (zone.has_hw) {
+            std::cout << ", \"cycles\": " << zone.hw.cycles
+                      << ", \"instructions\": " << zone.hw.instructions
+                      << ", \"ipc\": " << zone.ipc()
+                      << ", \"cache_misses_per_step\": " << std::setprecision(6)
+                      << zone.perItem(zone.hw.cache_misses)
+                      << ", \"branch_misses_per_step\": " << zone.perItem(zone.hw.branch_misses);
+        }
+        std::cout << "}";
+        first = false;
+    }
+    std::cout << "\n  ]\n}" << std::endl;
+    return 0;
+}
+
+int run_headless(int argc, char** argv) {
+    const long long total_steps = arg_long(argc, argv, "--steps", 0);        // 0 = until interrupted
+    const float duration = arg_float(argc, argv, "--duration", 0.0f);       // Seconds, 0 = no limit
+    const long batch = std::max(1LL, arg_long(argc, argv, "--batch", 100000));
+    float dt = arg_float(argc, argv, "--dt", 0.01f);
+    const int particles = arg_int(argc, argv, "--particles", 0);
+    const int metrics_port = arg_int(argc, argv, "--metrics-port", 0);
+    const std::string checkpoint_path = arg_string(argc, argv, "--checkpoint", "");
+    const float checkpoint_every = arg_float(argc, argv, "--checkpoint-every", 60.0f);
+    const std::string output_path = arg_string(argc, argv, "--output", "");
+    const std::string writer_backend = arg_string(argc, argv, "--writer", "uring");
+    const int output_buffer_mb = std::max(1, arg_int(argc, argv, "--output-buffer-mb", 8));
+
+    LorenzSolver solver;
+    Checkpoint cp;
+    cp.params = solver.getParameters();
+    cp.dt = dt;
+    glm::vec3 state = solver.getState();
+    if (!checkpoint_path.empty() && has_flag(argc, argv, "--resume")) {
+        if (read_checkpoint(checkpoint_path, cp)) {
+            state = glm::vec3(cp.state[0], cp.state[1], cp.state[2]);
+            solver.setParameters(cp.params.sigma, cp.params.rho, cp.params.beta);
+            dt = cp.dt;
+            std::cout << "Resumed from " << checkpoint_path << " at step " << cp.steps << std::endl;
+        } else {
+            std::cerr << "Cannot resume from " << checkpoint_path << ", starting fresh" << std::endl;
+        }
+    }
+
+    // Optional ensemble stepped alongside the reference trajectory
+    std::unique_ptr<WorkerPool> pool;
+    std::unique_ptr<Ensemble> ensemble;
+    if (particles > 0) {
+        pool.reset(new WorkerPool(arg_int(argc, argv, "--threads", 0)));
+        ensemble.reset(new Ensemble(particles, *pool));
+        ensemble->seedBall(state, 1.0f);
+    }
+
+    // Everything below is written by this loop and only read by the scraper
+    MetricsRegistry& registry = MetricsRegistry::instance();
+    Counter& steps_total = registry.counter("lorenz_steps_total", "RK4 steps of the reference trajectory");
+    Counter& particle_steps_total = registry.counter("lorenz_particle_steps_total", "RK4 steps summed over the ensemble");
+    Gauge& steps_rate = registry.gauge("lorenz_steps_per_second", "Reference trajectory steps per second");
+    Gauge& p50 = registry.gauge("lorenz_frame_time_ms", "Batch (frame) duration percentiles", "quantile=\"0.5\"");
+    Gauge& p95 = registry.gauge("lorenz_frame_time_ms", "Batch (frame) duration percentiles", "quantile=\"0.95\"");
+    Gauge& p99 = registry.gauge("lorenz_frame_time_ms", "Batch (frame) duration percentiles", "quantile=\"0.99\"");
+    Gauge& pmax = registry.gauge("lorenz_frame_time_ms", "Batch (frame) duration percentiles", "quantile=\"1\"");
+    std::atomic<int64_t> checkpoint_written_ns{0};
+    registry.callback("lorenz_checkpoint_age_seconds", "Seconds since the last checkpoint (-1 = none)", "",
+                      [&checkpoint_written_ns]() {
+        int64_t written = checkpoint_written_ns.load(std::memory_order_relaxed);
+        if (!written) return -1.0;
+        int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            Clock::now().time_since_epoch()).count();
+        return (now - written) * 1e-9;
+    });
+    registry.callback("lorenz_worker_jobs_pending", "Worker jobs handed out and not yet finished", "",
+                      []() { return static_cast<double>(WorkerPool::pendingJobs()); });
+    memory::exportMetrics();
+
+    MetricsServer server(metrics_port);
+    if (metrics_port > 0 && !server.start()) return -1;
+
+    // Every state of the reference trajectory, written behind the integration
+    std::unique_ptr<TrajectoryWriter> writer;
+    std::vector<glm::vec3> stage;
+    if (!output_path.empty()) {
+        writer.reset(new TrajectoryWriter(output_path, static_cast<size_t>(output_buffer_mb) << 20,
+                                          writer_backend != "pwrite", !has_flag(argc, argv, "--no-direct")));
+        if (!writer->ok()) return -1;
+        stage.resize(4096);
+        std::cout << "Writing states to " << output_path << " via " << writer->backendName()
+                  << (writer->direct() ? " (O_DIRECT)" : " (page cache)") << std::endl;
+    }
+
+    std::signal(SIGINT, on_interrupt);
+    std::signal(SIGTERM, on_interrupt);
+
+    std::cout << "Headless run: dt " << dt << ", batch " << batch << " steps"
+              << (particles ? ", " + std::to_string(particles) + " particles" : std::string())
+              << " (Ctrl-C to stop)" << std::endl;
+
+    HdrHistogram batch_times;
+    const LorenzParams params = solver.getParameters();
+    uint64_t steps_done = 0;
+    uint64_t rate_steps = 0;
+    auto run_start = Clock::now();
+    auto rate_timer = run_start;
+    auto checkpoint_timer = run_start;
+
+    auto save = [&]() {
+        if (checkpoint_path.empty()) return;
+        cp.steps += steps_done;
+        steps_done = 0;
+        cp.state[0] = state.x;
+        cp.state[1] = state.y;
+        cp.state[2] = state.z;
+        cp.params = params;
+        cp.dt = dt;
+        if (write_checkpoint(checkpoint_path, cp)) {
+            checkpoint_written_ns.store(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                Clock::now().time_since_epoch()).count(), std::memory_order_relaxed);
+        } else {
+            std::cerr << "Failed to write checkpoint " << checkpoint_path << std::endl;
+        }
+    };
+
+    uint64_t run_steps = 0;
+    while (!g_interrupted) {
+        if (total_steps > 0 && run_steps >= static_cast<uint64_t>(total_steps)) break;
+        if (duration > 0.0f && seconds_since(run_start) >= duration) break;
+
+        long n = batch;
+        if (total_steps > 0) n = static_cast<long>(std::min<uint64_t>(n, total_steps - run_steps));
+
+        auto batch_start = Clock::now();
+        if (writer) {
+            for (long done = 0; done < n; ) {
+                long m = std::min<long>(n - done, static_cast<long>(stage.size()));
+                for (long i = 0; i < m; ++i) {
+                    state = solver.rk4Step(state, dt);
+                    stage[i] = state;
+                }
+                writer->append(stage.data(), static_cast<size_t>(m));
+                done += m;
+            }
+        } else {
+            state = solver.integrate(state, dt, n);
+        }
+        if (ensemble) {
+            ensemble->step(params, dt, n);
+            particle_steps_total.add(static_cast<uint64_t>(n) * particles);
+        }
+        batch_times.record(std::chrono::duration_cast<std::chrono::microseconds>(
+            Clock::now() - batch_start).count());
+
+        steps_total.add(n);
+        steps_done += n;
+        run_steps += n;
+        rate_steps += n;
+
+        double elapsed = seconds_since(rate_timer);
+        if (elapsed >= 1.0) {
+            steps_rate.set(rate_steps / elapsed);
+            p50.set(batch_times.percentile(50.0) / 1000.0);
+            p95.set(batch_times.percentile(95.0) / 1000.0);
+            p99.set(batch_times.percentile(99.0) / 1000.0);
+            pmax.set(batch_times.max() / 1000.0);
+            rate_steps = 0;
+            rate_timer = Clock::now();
+        }
+        if (seconds_since(checkpoint_timer) >= checkpoint_every) {
+            save();
+            checkpoint_timer = Clock::now();
+        }
+    }
+    save();
+
+    double seconds = seconds_since(run_start);
+    std::cout << std::fixed << std::setprecision(3)
+              << "Ran " << run_steps << " steps in " << seconds << " s ("
+              << std::setprecision(0) << run_steps / std::max(seconds, 1e-9) << " steps/s)" << std::endl;
+    std::cout << std::setprecision(6) << "Final state: (" << state.x << ", " << state.y << ", "
+              << state.z << ")" << std::endl;
+    if (writer) {
+        bool written = writer->close();
+        std::cout << std::setprecision(1) << "Output: " << writer->bytesWritten() / 1048576.0 << " MB in "
+                  << std::setprecision(3) << writer->seconds() << " s (" << std::setprecision(1)
+                  << writer->megabytesPerSecond() << " MB/s, " << writer->backendName()
+                  << (writer->direct() ? ", O_DIRECT" : "") << "), integration stalled "
+                  << writer->stallMs() << " ms" << std::endl;
+        if (!written) return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,147 @@
+// job_system.cpp - Coroutine job resumption on the render thread and a worker
+#include "job_system.h"
+#include <algorithm>
+#include <iostream>
+
+Job& Job::operator=(Job&& other) noexcept {
+    if (this != &other) {
+        if (handle_) handle_.destroy();
+        handle_ = other.handle_;
+        other.handle_ = nullptr;
+    }
+    return *this;
+}
+
+bool Job::resume() {
+    if (!handle_ || handle_.done()) return true;
+    handle_.resume();
+    if (handle_.done() && handle_.promise().error) {
+        std::rethrow_exception(handle_.promise().error);
+    }
+    return handle_.done();
+}
+
+JobScheduler::JobScheduler()
+    : worker_([this]() { workerLoop(); })
+{
+}
+
+JobScheduler::~JobScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        for (auto& entry : entries_) entry->cancelled = true;
+    }
+    wake_.notify_all();
+    worker_.join();
+}
+
+int JobScheduler::start(const std::string& name, const Factory& factory, bool on_worker) {
+    auto entry = std::make_shared<Entry>();
+    entry->name = name;
+    entry->on_worker = on_worker;
+    entry->context.reset(new JobContext());
+    entry->job.reset(new Job(factory(*entry->context)));   // Suspended until first resumed
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    entry->id = next_id_++;
+    entries_.push_back(entry);
+    wake_.notify_all();
+    return entry->id;
+}
+
+void JobScheduler::cancel(int id) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& entry : entries_) {
+            if (entry->id == id) entry->cancelled = true;
+        }
+    }
+    reap();
+}
+
+bool JobScheduler::step(Entry& entry, double slice_ms) {
+    entry.context->deadline_ = JobContext::Clock::now() +
+        std::chrono::duration_cast<JobContext::Clock::duration>(std::chrono::duration<double, std::milli>(slice_ms));
+    try {
+        return entry.job->resume();
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Job '" << entry.name << "' failed: " << e.what() << std::endl;
+    }
+    catch (...) {
+        std::cerr << "Job '" << entry.name << "' failed: unknown exception" << std::endl;
+    }
+    return true;
+}
+
+void JobScheduler::reap() {
+    // A job still being resumed holds its own reference, so its coroutine is
+    // destroyed once that resume returns
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.erase(std::remove_if(entries_.begin(), entries_.end(), [](const std::shared_ptr<Entry>& entry) {
+        return entry->cancelled || entry->finished;
+    }), entries_.end());
+}
+
+void JobScheduler::runFrame(double budget_ms) {
+    auto end = JobContext::Clock::now() +
+        std::chrono::duration_cast<JobContext::Clock::duration>(std::chrono::duration<double, std::milli>(budget_ms));
+    std::vector<std::shared_ptr<Entry>> frame_jobs;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& entry : entries_) {
+            if (!entry->on_worker) frame_jobs.push_back(entry);
+        }
+    }
+    if (frame_jobs.empty()) return;
+
+    // Split what is left of the budget evenly over the jobs still to run
+    for (size_t i = 0; i < frame_jobs.size(); ++i) {
+        double left_ms = std::chrono::duration<double, std::milli>(end - JobContext::Clock::now()).count();
+        if (left_ms <= 0.0) break;
+        Entry& entry = *frame_jobs[i];
+        if (entry.cancelled) continue;
+        if (step(entry, left_ms / (frame_jobs.size() - i))) entry.finished = true;
+    }
+    reap();
+}
+
+void JobScheduler::workerLoop() {
+    const double kSliceMs = 5.0;
+    for (;;) {
+        std::vector<std::shared_ptr<Entry>> work;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [this]() {
+                if (stopping_) return true;
+                for (auto& entry : entries_) {
+                    if (entry->on_worker && !entry->cancelled && !entry->finished) return true;
+                }
+                return false;
+            });
+            if (stopping_) return;
+            for (auto& entry : entries_) {
+                if (entry->on_worker) work.push_back(entry);
+            }
+        }
+        for (auto& entry : work) {
+            if (!entry->cancelled && step(*entry, kSliceMs)) entry->finished = true;
+        }
+        reap();
+    }
+}
+
+std::vector<JobScheduler::Info> JobScheduler::jobs() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<Info> infos;
+    for (const auto& entry : entries_) {
+        infos.push_back({entry->id, entry->name, entry->context->progress(), entry->on_worker});
+    }
+    return infos;
+}
+
+bool JobScheduler::active() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return !entries_.empty();
+}
@@ -0,0 +1,102 @@
+// dispatch.cpp - cpuid-based selection of the widest available kernel variant
+#include "kernels.h"
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+
+namespace kernels {
+
+using Rk4BatchFn = void (*)(float*, float*, float*, size_t, const LorenzParams&, float, long);
+
+namespace scalar { void rk4Batch(float*, float*, float*, size_t, const LorenzParams&, float, long); }
+#ifdef LORENZ_X86_KERNELS
+namespace sse42  { void rk4Batch(float*, float*, float*, size_t, const LorenzParams&, float, long); }
+namespace avx2   { void rk4Batch(float*, float*, float*, size_t, const LorenzParams&, float, long); }
+namespace avx512 { void rk4Batch(float*, float*, float*, size_t, const LorenzParams&, float, long); }
+#endif
+
+namespace {
+
+Rk4BatchFn variant(SimdPath path) {
+    switch (path) {
+        #ifdef LORENZ_X86_KERNELS
+        case SimdPath::AVX512: return avx512::rk4Batch;
+        case SimdPath::AVX2:   return avx2::rk4Batch;
+        case SimdPath::SSE42:  return sse42::rk4Batch;
+        #endif
+        default:               return scalar::rk4Batch;
+    }
+}
+
+SimdPath parsePath(const char* name) {
+    if (std::strcmp(name, "avx512") == 0) return SimdPath::AVX512;
+    if (std::strcmp(name, "avx2") == 0) return SimdPath::AVX2;
+    if (std::strcmp(name, "sse4.2") == 0 || std::strcmp(name, "sse42") == 0) return SimdPath::SSE42;
+    return SimdPath::Scalar;
+}
+
+SimdPath initialPath() {
+    SimdPath path = bestPath();
+    if (const char* cap = std::getenv("LORENZ_SIMD")) {
+        SimdPath requested = parsePath(cap);
+        if (requested < path) path = requested;
+    }
+    return path;
+}
+
+std::atomic<SimdPath>& current() {
+    static std::atomic<SimdPath> path{initialPath()};
+    return path;
+}
+
+} // namespace
+
+bool isSupported(SimdPath path) {
+    #ifdef LORENZ_X86_KERNELS
+    __builtin_cpu_init();
+    switch (path) {
+        case SimdPath::AVX512: return __builtin_cpu_supports("avx512f");
+        case SimdPath::AVX2:   return __builtin_cpu_supports("avx2");
+        case SimdPath::SSE42:  return __builtin_cpu_supports("sse4.2");
+        case SimdPath::Scalar: return true;
+    }
+    return false;
+    #else
+    return path == SimdPath::Scalar;
+    #endif
+}
+
+SimdPath bestPath() {
+    for (SimdPath path : {SimdPath::AVX512, SimdPath::AVX2, SimdPath::SSE42}) {
+        if (isSupported(path)) return path;
+    }
+    return SimdPath::Scalar;
+}
+
+SimdPath activePath() {
+    return current().load(std::memory_order_relaxed);
+}
+
+bool setPath(SimdPath path) {
+    if (!isSupported(path)) return false;
+    current().store(path, std::memory_order_relaxed);
+    return true;
+}
+
+const char* pathName(SimdPath path) {
+    switch (path) {
+        case SimdPath::AVX512: return "avx512";
+        case SimdPath::AVX2:   return "avx2";
+        case SimdPath::SSE42:  return "sse4.2";
+        case SimdPath::Scalar: return "scalar";
+    }
+    return "unknown";
+}
+
+void rk4Batch(float* x, float* y, float* z, size_t count,
+              const LorenzParams& params, float dt, long steps) {
+    variant(activePath())(x, y, z, count, params, dt, steps);
+}
+
+} // namespace kernels
@@ -0,0 +1,3 @@
+// rk4_avx2.cpp - AVX2 kernel variant (built with -mavx2)
+#define KERNEL_NS avx2
+#include "rk4_batch_impl.h"
@@ -0,0 +1,3 @@
+// rk4_avx512.cpp - AVX-512 kernel variant (built with -mavx512f)
+#define KERNEL_NS avx512
+#include "rk4_batch_impl.h"
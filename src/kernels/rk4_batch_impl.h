@@ -0,0 +1,74 @@
+// rk4_batch_impl.h - Batched RK4 kernel body, compiled once per instruction set
+//
+// Included by rk4_<isa>.cpp with KERNEL_NS set; CMake gives each of those
+// files its own -m flags. The loops are plain scalar code that the compiler
+// vectorises for the target. Keep the operation order identical to
+// LorenzSolver::rk4Step (and builds at -ffp-contract=off) so every path
+// produces the same bits.
+#include <algorithm>
+#include "kernels.h"
+
+#ifndef KERNEL_NS
+#error "Define KERNEL_NS before including rk4_batch_impl.h"
+#endif
+
+namespace kernels {
+namespace KERNEL_NS {
+
+void rk4Batch(float* x, float* y, float* z, size_t count,
+              const LorenzParams& params, float dt, long steps) {
+    // Work on L1-sized blocks so all steps run without touching memory
+    constexpr size_t kBlock = 256;
+    alignas(64) float bx[kBlock];
+    alignas(64) float by[kBlock];
+    alignas(64) float bz[kBlock];
+
+    const float sigma = params.sigma;
+    const float rho = params.rho;
+    const float beta = params.beta;
+    const float half = 0.5f * dt;
+    const float sixth = dt / 6.0f;
+
+    for (size_t base = 0; base < count; base += kBlock) {
+        const size_t n = std::min(kBlock, count - base);
+        std::copy(x + base, x + base + n, bx);
+        std::copy(y + base, y + base + n, by);
+        std::copy(z + base, z + base + n, bz);
+
+        for (long s = 0; s < steps; ++s) {
+            for (size_t i = 0; i < n; ++i) {
+                const float x0 = bx[i], y0 = by[i], z0 = bz[i];
+
+                const float k1x = sigma * (y0 - x0);
+                const float k1y = x0 * (rho - z0) - y0;
+                const float k1z = x0 * y0 - beta * z0;
+
+                const float x1 = x0 + half * k1x, y1 = y0 + half * k1y, z1 = z0 + half * k1z;
+                const float k2x = sigma * (y1 - x1);
+                const float k2y = x1 * (rho - z1) - y1;
+                const float k2z = x1 * y1 - beta * z1;
+
+                const float x2 = x0 + half * k2x, y2 = y0 + half * k2y, z2 = z0 + half * k2z;
+                const float k3x = sigma * (y2 - x2);
+                const float k3y = x2 * (rho - z2) - y2;
+                const float k3z = x2 * y2 - beta * z2;
+
+                const float x3 = x0 + dt * k3x, y3 = y0 + dt * k3y, z3 = z0 + dt * k3z;
+                const float k4x = sigma * (y3 - x3);
+                const float k4y = x3 * (rho - z3) - y3;
+                const float k4z = x3 * y3 - beta * z3;
+
+                bx[i] = x0 + sixth * (k1x + 2.0f * k2x + 2.0f * k3x + k4x);
+                by[i] = y0 + sixth * (k1y + 2.0f * k2y + 2.0f * k3y + k4y);
+                bz[i] = z0 + sixth * (k1z + 2.0f * k2z + 2.0f * k3z + k4z);
+            }
+        }
+
+        std::copy(bx, bx + n, x + base);
+        std::copy(by, by + n, y + base);
+        std::copy(bz, bz + n, z + base);
+    }
+}
+
+} // namespace KERNEL_NS
+} // namespace kernels
@@ -0,0 +1,3 @@
+// rk4_scalar.cpp - Portable baseline kernel (no extra instruction-set flags)
+#define KERNEL_NS scalar
+#include "rk4_batch_impl.h"
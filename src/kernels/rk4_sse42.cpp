@@ -0,0 +1,3 @@
+// rk4_sse42.cpp - SSE4.2 kernel variant (built with -msse4.2)
+#define KERNEL_NS sse42
+#include "rk4_batch_impl.h"
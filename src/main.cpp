@@ -2,9 +2,12 @@
 // Complete working implementation
 
 #include <iostream>
+#include <fstream>
 #include <vector>
 #include <chrono>
 #include <cmath>
+#include <algorithm>
+#include <cstdio>
 
 // OpenGL
 #include <glad/glad.h>
@@ -26,6 +29,29 @@
 #include "shader.h"
 #include "camera.h"
 #include "lorenz_solver.h"
+#include "headless.h"
+#include "sweep.h"
+#include "memory_tracker.h"
+#include "profiler.h"
+#include "hdr_histogram.h"
+#include "gui_overlay.h"
+#include "framebuffer.h"
+#include "fullscreen_pass.h"
+#include "trail_cache.h"
+#include "gpu_timer.h"
+#include "dynamic_resolution.h"
+#include "anti_aliasing.h"
+#include "bloom.h"
+#include "trail_shaders.h"
+#include "tube_mesh.h"
+#include "dust_cloud.h"
+#include "gpu_ensemble.h"
+#include "timeline.h"
+#include "task_graph.h"
+#include "worker_pool.h"
+#include "job_system.h"
+#include "analysis_jobs.h"
+#include "result_cache.h"
 
 // Global state
 struct AppState {
@@ -54,11 +80,99 @@ struct AppState {
     // Visualization
     int max_points = 50000;
     float line_alpha = 1.0f;
+    bool incremental_trail = true;  // Draw only new segments over the cached trail
+    bool weighted_oit = true;       // Order-independent blending when Line Alpha < 1
+    
+    // Spline trails: keep every Nth step and rebuild the curve from tangents
+    TrailPrimitive trail_primitive = TrailPrimitive::Lines;
+    int sample_stride = 1;
+    float spline_pixels = 4.0f;     // Screen length of one tessellated sub-segment
+    
+    // Lit tube instead of lines (presentation renders)
+    bool tube = false;
+    float tube_radius = 0.3f;
+    int tube_sides = 0;             // Current LOD, for display
+    
+    // Dust cloud: particles seeded in a small ball around the current state,
+    // advected with the trajectory to show sensitivity to initial conditions
+    bool dust = false;
+    int dust_particles = 1000000;
+    float dust_radius = 0.5f;
+    float dust_point_size = 1.5f;
+    float dust_alpha = 0.2f;
+    bool dust_reseed = true;        // Reseed before the next frame
+    double dust_ms = 0.0;           // CPU step + stream, for display
+    bool dust_gpu = false;          // Step in a compute shader instead of on the workers
+    bool compute_available = false;
+    GpuEnsemble::CheckStats dust_checks;
+    
+    // Timeline: the whole run is checkpointed; any span is replayed on demand
+    bool scrubbing = false;
+    float timeline_position = 1.0f; // End of the viewed span, as a fraction of the run
+    int timeline_span = 20000;      // Steps in view
+    unsigned long long timeline_steps = 0;    // For display
+    size_t timeline_checkpoints = 0;
+    size_t timeline_bytes = 0;
+    size_t timeline_hits = 0;
+    size_t timeline_misses = 0;
+    double timeline_replay_ms = 0.0;
+    
+    // Analysis jobs: coroutines resumed within a per-frame budget, or on a worker
+    JobScheduler* jobs = nullptr;   // Owned by main()
+    float analysis_budget_ms = 4.0f;
+    bool analysis_on_worker = false;
+    Published<BifurcationResult> bifurcation;
+    Published<LyapunovResult> lyapunov;
+    ResultCache* results = nullptr; // Owned by main(); finished analyses persist across runs
+    int cache_limit_mb = 256;
+    
+    // Dynamic resolution (scene only; the GUI stays native)
+    bool dynamic_resolution = true;
+    float scene_budget_ms = 8.0f;
+    float min_scene_scale = 0.5f;
+    float upscale_sharpness = 0.4f;
+    float scene_scale = 1.0f;       // Current, for display
+    
+    // Anti-aliasing
+    AaMode aa_mode = AaMode::Msaa;
+    int msaa_samples = 4;
+    double aa_cost_ms[static_cast<int>(AaMode::Count)] = {};   // Scene pass GPU ms per mode
+    
+    // Bloom
+    bool bloom = false;
+    float bloom_threshold = 0.6f;
+    float bloom_intensity = 0.8f;
+    double bloom_ms = 0.0;
+    
+    // Memory
+    int history_budget_mb = 0;  // 0 = unlimited
+    
+    // Profiling
+    bool hw_counters = false;
+    std::string critical_path;      // Frame task graph, from the last frame
+    double critical_path_ms = 0.0;
+    double frame_graph_ms = 0.0;
+    
+    // GUI overlay cache
+    bool gui_cache = true;
+    float gui_refresh = 0.5f;   // Seconds between forced rebuilds
+    bool gui_input = false;     // Set by input callbacks, consumed once per frame
+    
+    // Idle mode: when nothing changed, block on events instead of redrawing
+    bool idle_mode = true;
+    float idle_timeout = 1.0f;  // Seconds; upper bound on one wait
+    bool redraw = true;         // Resize: the next frame must be rendered
+    bool exposed = false;       // Window damaged while idle: repaint from the frame copy
     
     // Performance
     int frame_count = 0;
     double fps = 0.0;
     std::chrono::high_resolution_clock::time_point fps_timer;
+    
+    // Frame-time distribution in microseconds (1 us .. 60 s, 3 digits)
+    HdrHistogram frame_times;
+    std::chrono::high_resolution_clock::time_point last_frame;
+    double frame_p50 = 0.0, frame_p95 = 0.0, frame_p99 = 0.0, frame_max = 0.0;  // ms, refreshed with fps
 } g_state;
 
 // Forward declarations
@@ -67,9 +181,34 @@ void mouse_button_callback(GLFWwindow* window, int button, int action, int mods)
 void cursor_position_callback(GLFWwindow* window, double xpos, double ypos);
 void scroll_callback(GLFWwindow* window, double xoffset, double yoffset);
 void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods);
+void window_refresh_callback(GLFWwindow* window);
 void render_gui();
+uint64_t hash_values(const double* values, size_t count);
+uint64_t gui_signature(size_t trajectory_points);
+uint64_t scene_signature(const LorenzSolver& solver);
+uint64_t view_signature();
+int run_compute_check(int argc, char** argv);
+BifurcationSettings bifurcation_settings();
+LyapunovSettings lyapunov_settings();
 
-int main() {
+int main(int argc, char** argv) {
+    // Headless modes never open a window
+    if (has_flag(argc, argv, "--parareal")) {
+        return run_parareal(argc, argv);
+    }
+    if (has_flag(argc, argv, "--bench")) {
+        return run_benchmark(argc, argv);
+    }
+    if (has_flag(argc, argv, "--headless")) {
+        return run_headless(argc, argv);
+    }
+    if (has_flag(argc, argv, "--sweep")) {
+        return run_sweep(argc, argv);
+    }
+    if (has_flag(argc, argv, "--worker")) {
+        return run_sweep_worker(argc, argv);
+    }
+    
     // Initialize GLFW
     if (!glfwInit()) {
         std::cerr << "Failed to initialize GLFW" << std::endl;
@@ -80,7 +219,11 @@ int main() {
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 2);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-    glfwWindowHint(GLFW_SAMPLES, 4);  // 4x MSAA
+    glfwWindowHint(GLFW_SAMPLES, 0);  // Anti-aliasing is done offscreen (see AntiAliasing)
+    
+    // --compute-check validates the GPU ensemble in a hidden window (CI: llvmpipe under Xvfb)
+    bool compute_check = has_flag(argc, argv, "--compute-check");
+    glfwWindowHint(GLFW_VISIBLE, compute_check ? GLFW_FALSE : GLFW_TRUE);
     
     #ifdef __APPLE__
     glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
@@ -108,6 +251,7 @@ int main() {
     glfwSetCursorPosCallback(window, cursor_position_callback);
     glfwSetScrollCallback(window, scroll_callback);
     glfwSetKeyCallback(window, key_callback);
+    glfwSetWindowRefreshCallback(window, window_refresh_callback);
     
     // Load OpenGL functions with GLAD
     if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
@@ -115,9 +259,16 @@ int main() {
         return -1;
     }
     
+    if (compute_check) {
+        int result = run_compute_check(argc, argv);
+        glfwTerminate();
+        return result;
+    }
+    
     std::cout << "\n=== Lorenz Attractor Visualizer ===" << std::endl;
     std::cout << "OpenGL Version: " << glGetString(GL_VERSION) << std::endl;
     std::cout << "GPU: " << glGetString(GL_RENDERER) << std::endl;
+    std::cout << "SIMD path: " << kernels::pathName(kernels::activePath()) << std::endl;
     std::cout << "\nControls:" << std::endl;
     std::cout << "  SPACE     - Start/Stop simulation" << std::endl;
     std::cout << "  R         - Reset" << std::endl;
@@ -134,113 +285,466 @@ int main() {
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     glLineWidth(1.5f);
     
-    // Load shaders
-    Shader shader("shaders/basic.vert", "shaders/basic.frag");
-    
-    // Create Lorenz solver
-    LorenzSolver solver(g_state.sigma, g_state.rho, g_state.beta);
-    solver.setState(0.0, 1.0, 0.0);
-    
-    // Create OpenGL buffers
-    GLuint VAO, VBO;
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-    
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    
-    // Position attribute (location = 0)
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    
-    glBindVertexArray(0);
-    
-    #ifdef HAS_IMGUI
-    // Setup ImGui
-    IMGUI_CHECKVERSION();
-    ImGui::CreateContext();
-    ImGuiIO& io = ImGui::GetIO();
-    ImGui::StyleColorsDark();
-    ImGui_ImplGlfw_InitForOpenGL(window, true);
-    ImGui_ImplOpenGL3_Init("#version 420");
-    #endif
-    
-    g_state.fps_timer = std::chrono::high_resolution_clock::now();
-    
-    // Main loop
-    while (!glfwWindowShouldClose(window)) {
-        // Process input
-        glfwPollEvents();
-        
-        // Update simulation
-        if (g_state.running) {
-            for (int i = 0; i < g_state.steps_per_frame; ++i) {
-                solver.step(g_state.dt);
-                
-                // Limit trajectory size
-                if (solver.getTrajectory().size() > static_cast<size_t>(g_state.max_points)) {
-                    solver.clearOldest(g_state.max_points);
-                }
-            }
+    // Everything that owns GL objects lives in this scope, so their destructors
+    // run while the context still exists (before the ImGui and GLFW shutdown)
+    {
+        // Load shaders
+        TrailShaders trail_shaders;
+        if (!trail_shaders.tessellationAvailable()) {
+            std::cout << "Tessellation shaders unavailable; splines use instanced subdivision" << std::endl;
         }
+        Shader tube_shader("shaders/tube.vert", "shaders/tube.frag");
+        TubeMesh tube;
+        // One pool for the frame's data-parallel work (dust, timeline replay),
+        // pinned for the dust ensemble's first-touch placement. Its jobs take
+        // turns rather than oversubscribing the machine.
+        WorkerPool compute_pool;
+        Shader dust_shader("shaders/dust.vert", "shaders/dust.frag");
+        DustCloud dust(compute_pool);
+        GpuEnsemble gpu_dust;
+        g_state.compute_available = gpu_dust.available();
         
-        // Render
-        glClearColor(0.05f, 0.05f, 0.1f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        // Create Lorenz solver
+        LorenzSolver solver(g_state.sigma, g_state.rho, g_state.beta);
+        solver.setState(0.0, 1.0, 0.0);
         
-        // Use shader
-        shader.use();
+        // Checkpoints of the run for scrubbing; the viewed span is replayed into these
+        Timeline timeline(compute_pool);
+        Timeline::Points timeline_points, timeline_tangents;
+        uint64_t timeline_view = 0;         // Hash of the replayed span
+        uint64_t timeline_stride = 1;
+        unsigned long timeline_epoch = 0;   // Bumped on every replay
+        unsigned long draw_epoch = 0;       // History epoch of whatever is drawn
+        unsigned long last_source_epoch = 0;
+        bool last_scrubbing = false;
+        uint64_t draw_first = 0;            // Running index of the first drawn point (see TubeMesh::update)
+        uint64_t draw_end = 0;
+        uint64_t live_base = 0;             // draw_first - solver.getHistoryStart() while drawing live
         
-        // Set matrices
-        glm::mat4 view = g_state.camera.getViewMatrix();
-        glm::mat4 projection = g_state.camera.getProjectionMatrix(
-            (float)g_state.width / (float)g_state.height
-        );
+        // Over budget: drop the oldest history and keep the point limit below it
+        memory::setTrimmer(MemTag::SolverHistory, [&solver](size_t limit) {
+            size_t kept = solver.trimHistory(limit);
+            g_state.max_points = std::min(g_state.max_points, static_cast<int>(kept));
+            std::cout << "History over budget: trimmed to " << kept << " points" << std::endl;
+        });
         
-        shader.setMat4("view", glm::value_ptr(view));
-        shader.setMat4("projection", glm::value_ptr(projection));
-        shader.setFloat("alpha", g_state.line_alpha);
+        // Anti-aliasing happens in the scene targets; its per-mode scene timers
+        // also drive the resolution scale
+        AntiAliasing aa;
+        DynamicResolution resolution;
+        Bloom bloom;
         
-        // Update VBO with trajectory data
-        const auto& trajectory = solver.getTrajectory();
-    shader.setInt("totalPoints", trajectory.size());
-        if (!trajectory.empty()) {
-            glBindBuffer(GL_ARRAY_BUFFER, VBO);
-            glBufferData(GL_ARRAY_BUFFER, 
-                         trajectory.size() * sizeof(glm::vec3), 
-                         trajectory.data(), 
-                         GL_DYNAMIC_DRAW);
-            
-            // Draw
-            glBindVertexArray(VAO);
-            glDrawArrays(GL_LINE_STRIP, 0, trajectory.size());
-        }
+        // Trajectory buffer and cached trail image
+        TrailCache trail(0);
         
         #ifdef HAS_IMGUI
-        // Render ImGui
-        render_gui();
+        // Setup ImGui
+        IMGUI_CHECKVERSION();
+        ImGui::CreateContext();
+        ImGuiIO& io = ImGui::GetIO();
+        ImGui::StyleColorsDark();
+        ImGui_ImplGlfw_InitForOpenGL(window, true);
+        ImGui_ImplOpenGL3_Init("#version 420");
+        
+        GuiOverlay overlay;
         #endif
         
-        // Swap buffers
-        glfwSwapBuffers(window);
+        // Last rendered frame, kept while idle so window exposes can be repainted
+        // without re-rendering the scene
+        Framebuffer frame_copy({GL_RGBA8}, false);
+        FullscreenPass copy_pass("shaders/copy.frag");
+        uint64_t last_scene = 0;
         
-        // Update FPS
-        g_state.frame_count++;
-        auto now = std::chrono::high_resolution_clock::now();
-        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - g_state.fps_timer).count();
-        if (elapsed >= 1000) {
-            g_state.fps = g_state.frame_count / (elapsed / 1000.0);
-            g_state.frame_count = 0;
-            g_state.fps_timer = now;
+        // Per-frame work as a task graph: the dust cloud (GL, so on this thread)
+        // overlaps the simulate > budgets > timeline chain. Simulate and timeline
+        // run on the pool; budgets (main-thread trimmers) and dust run here
+        WorkerPool frame_pool(2, false);
+        TaskGraph frame_graph(frame_pool);
+        glm::vec3 frame_head;       // Solver state and parameters before this frame's steps
+        LorenzParams frame_params;
+        TaskGraph::TaskId simulate_task = frame_graph.add("simulate", [&]() {
+            if (g_state.running) {
+                PROFILE_ZONE("simulate", g_state.steps_per_frame);
+                // Evicting one point per step would invalidate the trail cache every
+                // frame, so with it on the history overshoots by 1/8 and drops in chunks
+                solver.setRecordStride(g_state.sample_stride);
+                size_t limit = g_state.max_points;
+                size_t slack = g_state.incremental_trail ? limit / 8 : 0;
+                for (int i = 0; i < g_state.steps_per_frame; ++i) {
+                    timeline.record(solver.getState(), solver.getParameters(), g_state.dt);
+                    solver.step(g_state.dt);
+                    
+                    // Limit trajectory size
+                    if (solver.getTrajectory().size() > limit + slack) {
+                        solver.clearOldest(limit);
+                    }
+                }
+            }
+        });
+        TaskGraph::TaskId budgets_task = frame_graph.add("budgets", [&]() {
+            memory::setBudget(MemTag::SolverHistory, static_cast<size_t>(g_state.history_budget_mb) << 20);
+            memory::enforceBudgets();
+        }, {simulate_task}, TaskGraph::Affinity::Main);    // Trimmers touch g_state and the solver
+        frame_graph.add("timeline", [&]() {
+            // Scrubbing: replay the viewed span whenever it moves (or the run grows under it)
+            if (g_state.scrubbing) {
+                uint64_t span = static_cast<uint64_t>(g_state.timeline_span);
+                uint64_t last = static_cast<uint64_t>(g_state.timeline_position * timeline.steps());
+                uint64_t first = last > span ? last - span : 0;
+                uint64_t stride = std::max<uint64_t>(1, span / std::max(1, g_state.max_points));
+                double view_values[] = {
+                    static_cast<double>(first), static_cast<double>(last), static_cast<double>(stride),
+                };
+                uint64_t view = hash_values(view_values, 3);
+                if (view != timeline_view) {
+                    PROFILE_ZONE("timeline", last - first);
+                    timeline.window(first, last, stride, timeline_points, timeline_tangents);
+                    timeline_view = view;
+                    timeline_stride = stride;
+                    ++timeline_epoch;
+                    g_state.timeline_hits = timeline.lastHits();
+                    g_state.timeline_misses = timeline.lastMisses();
+                    g_state.timeline_replay_ms = timeline.lastReplayMs();
+                }
+            } else {
+                timeline_view = 0;
+            }
+            g_state.timeline_steps = timeline.steps();
+            g_state.timeline_checkpoints = timeline.checkpoints();
+            g_state.timeline_bytes = timeline.checkpointBytes();
+        }, {budgets_task});
+        frame_graph.add("dust", [&]() {
+            // Dust cloud: one batched advance per frame on the worker pool
+            if (g_state.dust) {
+                auto start = std::chrono::high_resolution_clock::now();
+                size_t particles = static_cast<size_t>(g_state.dust_particles);
+                bool gpu = g_state.dust_gpu && gpu_dust.available();
+                if (g_state.dust_reseed || (gpu ? gpu_dust.size() : dust.size()) != particles) {
+                    if (gpu) {
+                        dust.release();
+                        gpu_dust.seed(particles, frame_head, g_state.dust_radius);
+                    } else {
+                        dust.seed(particles, frame_head, g_state.dust_radius);
+                    }
+                    g_state.dust_reseed = false;
+                    g_state.redraw = true;
+                } else if (g_state.running) {
+                    PROFILE_ZONE("dust", particles * g_state.steps_per_frame);
+                    if (gpu) {
+                        gpu_dust.advance(frame_params, g_state.dt, g_state.steps_per_frame);
+                        g_state.dust_checks = gpu_dust.checkStats();
+                    } else {
+                        dust.advance(frame_params, g_state.dt, g_state.steps_per_frame);
+                    }
+                }
+                g_state.dust_ms = std::chrono::duration<double, std::milli>(
+                    std::chrono::high_resolution_clock::now() - start).count();
+            }
+        }, {}, TaskGraph::Affinity::Main);
+        
+        // Long analyses get a slice of each frame; they have no dependencies here
+        // The cache outlives the scheduler: a worker job may still be storing into it
+        ResultCache results(ResultCache::defaultDirectory(), static_cast<size_t>(g_state.cache_limit_mb) << 20);
+        g_state.results = &results;
+        JobScheduler jobs;
+        g_state.jobs = &jobs;
+        loadCached(results, bifurcation_settings(), g_state.bifurcation);   // Same parameters as last time: no recompute
+        loadCached(results, lyapunov_settings(), g_state.lyapunov);
+        frame_graph.add("analysis", [&]() {
+            jobs.runFrame(g_state.analysis_budget_ms);
+        }, {}, TaskGraph::Affinity::Main);
+        unsigned long last_analysis = 0;
+        
+        g_state.fps_timer = std::chrono::high_resolution_clock::now();
+        g_state.last_frame = g_state.fps_timer;
+        
+        // Main loop
+        while (!glfwWindowShouldClose(window)) {
+            // Process input; sleep in the event queue if the last frame left nothing to do
+            bool settling = false;
+            #ifdef HAS_IMGUI
+            settling = overlay.settling();
+            #endif
+            bool analysing = jobs.active();
+            if (g_state.idle_mode && !g_state.running && !g_state.gui_input && !g_state.redraw && !settling &&
+                !analysing) {
+                glfwWaitEventsTimeout(g_state.idle_timeout);
+                g_state.last_frame = std::chrono::high_resolution_clock::now();  // Waiting is not frame time
+            } else {
+                glfwPollEvents();
+            }
+            
+            // Simulation, analysis and dust for this frame
+            frame_head = solver.getState();
+            frame_params = solver.getParameters();
+            frame_graph.run();
+            g_state.critical_path = frame_graph.criticalPathNames();
+            g_state.critical_path_ms = frame_graph.criticalPathMs();
+            g_state.frame_graph_ms = frame_graph.wallMs();
+            
+            // Dirty tracking: input, resize, a running simulation or any change to the
+            // camera, trajectory or render settings produces a frame. Running jobs
+            // redraw for their progress, and a published result once more
+            uint64_t scene = scene_signature(solver);
+            unsigned long analysis = g_state.bifurcation.revision() + g_state.lyapunov.revision();
+            bool dirty = !g_state.idle_mode || g_state.running || g_state.gui_input || g_state.redraw ||
+                         settling || scene != last_scene || analysing || analysis != last_analysis;
+            last_scene = scene;
+            last_analysis = analysis;
+            g_state.redraw = false;
+            if (!dirty) {
+                if (g_state.exposed && frame_copy.valid()) {
+                    Framebuffer::bindDefault(g_state.width, g_state.height);
+                    glDisable(GL_BLEND);
+                    copy_pass.drawTexture(frame_copy.colorTexture(), "source");
+                    glEnable(GL_BLEND);
+                    glfwSwapBuffers(window);
+                }
+                g_state.exposed = false;
+                continue;
+            }
+            g_state.exposed = false;
             
-            // Update window title
-            std::string title = "Lorenz Attractor - " + 
-                              std::to_string((int)g_state.fps) + " FPS | " +
-                              std::to_string(trajectory.size()) + " points";
-            if (g_state.running) title += " [RUNNING]";
-            else title += " [PAUSED - Press SPACE]";
-            glfwSetWindowTitle(window, title.c_str());
+            // Render; every path below covers the whole window, so the clear
+            // colour is only used by the scene targets
+            glClearColor(0.05f, 0.05f, 0.1f, 1.0f);
+            
+            resolution.enabled = g_state.dynamic_resolution;
+            resolution.target_ms = g_state.scene_budget_ms;
+            resolution.min_scale = g_state.min_scene_scale;
+            resolution.sharpness = g_state.upscale_sharpness;
+            aa.mode = g_state.aa_mode;
+            aa.msaa_samples = g_state.msaa_samples;
+            
+            bloom.enabled = g_state.bloom;
+            bloom.threshold = g_state.bloom_threshold;
+            bloom.intensity = g_state.bloom_intensity;
+            
+            // Scaled or post-processed scenes go through an offscreen target
+            bool offscreen = resolution.active() || aa.postProcess() || bloom.enabled;
+            int scene_w = resolution.sceneWidth(g_state.width);
+            int scene_h = resolution.sceneHeight(g_state.height);
+            
+            // Use shader; without tessellation, tessellated splines fall back to instanced ones
+            TrailPrimitive primitive = trail_shaders.effective(g_state.trail_primitive);
+            const Shader& line_shader = trail_shaders.get(primitive, aa.analyticLines());
+            line_shader.use();
+            
+            // Set matrices
+            glm::mat4 view = g_state.camera.getViewMatrix();
+            glm::mat4 projection = g_state.camera.getProjectionMatrix(
+                (float)g_state.width / (float)g_state.height
+            );
+            
+            line_shader.setMat4("view", glm::value_ptr(view));
+            line_shader.setMat4("projection", glm::value_ptr(projection));
+            line_shader.setFloat("alpha", g_state.line_alpha);
+            line_shader.setVec2("viewport", (float)scene_w, (float)scene_h);
+            line_shader.setFloat("lineWidth", 1.5f * scene_w / g_state.width);
+            bool oit = g_state.weighted_oit && g_state.line_alpha < 1.0f;
+            line_shader.setBool("weightedOit", oit);
+            uint64_t stride = g_state.scrubbing ? timeline_stride : static_cast<uint64_t>(solver.getRecordStride());
+            // Replayed tangents are per step (see Timeline::window)
+            line_shader.setFloat("segmentTime", g_state.scrubbing ? stride : g_state.dt * stride);
+            line_shader.setFloat("pixelsPerSegment", g_state.spline_pixels);
+            line_shader.setInt("subdivisions", trail.subdivisions);
+            
+            // Upload and draw only what is new since the last frame
+            const auto& trajectory = solver.getTrajectory();
+            
+            // Live history, or the replayed timeline span while scrubbing; switching
+            // sources counts as a new history epoch
+            const glm::vec3* points = trajectory.data();
+            const glm::vec3* tangents = solver.getTangents().data();
+            size_t point_count = trajectory.size();
+            unsigned long source_epoch = solver.getHistoryEpoch();
+            if (g_state.scrubbing) {
+                points = timeline_points.data();
+                tangents = timeline_tangents.data();
+                point_count = timeline_points.size();
+                source_epoch = timeline_epoch;
+            }
+            bool source_changed = source_epoch != last_source_epoch || g_state.scrubbing != last_scrubbing;
+            if (source_changed) ++draw_epoch;
+            
+            // The live history numbers its points itself; a replayed span shares
+            // no points with what was drawn before, so it is numbered after it
+            if (!g_state.scrubbing) {
+                if (last_scrubbing) live_base = draw_end - solver.getHistoryStart();
+                draw_first = live_base + solver.getHistoryStart();
+            } else if (source_changed) {
+                draw_first = draw_end;
+            }
+            draw_end = draw_first + point_count;
+            last_source_epoch = source_epoch;
+            last_scrubbing = g_state.scrubbing;
+            line_shader.setInt("totalPoints", point_count);
+            {
+                ProfileZone zone("draw");
+                aa.timer().begin();
+                trail.enabled = g_state.incremental_trail;
+                trail.setSamples(aa.sceneSamples());
+                trail.setOrderIndependent(oit);
+                trail.setPrimitive(primitive);
+                GLuint scene = offscreen ? resolution.sceneTarget(g_state.width, g_state.height) : 0;
+                if (g_state.tube) {
+                    // LOD from the tube's projected radius at the orbit distance
+                    float pixels_per_unit = scene_h / (2.0f * std::tan(glm::radians(g_state.camera.fov) * 0.5f) *
+                                                       g_state.camera.distance);
+                    g_state.tube_sides = TubeMesh::sidesForRadius(g_state.tube_radius * pixels_per_unit);
+                    tube.radius = g_state.tube_radius;
+                    {
+                        PROFILE_ZONE("tube mesh");
+                        tube.update(points, tangents, point_count, draw_first, g_state.tube_sides);
+                    }
+                    
+                    tube_shader.use();
+                    tube_shader.setMat4("view", glm::value_ptr(view));
+                    tube_shader.setMat4("projection", glm::value_ptr(projection));
+                    tube_shader.setFloat("alpha", g_state.line_alpha);
+                    tube_shader.setBool("weightedOit", oit);
+                    tube_shader.setVec3("baseColor", 0.2f, 0.5f, 1.0f);
+                    trail.render([&tube](size_t first, size_t count) { tube.drawRange(first, count); },
+                                 point_count, draw_epoch, view_signature(),
+                                 scene_w, scene_h, scene);
+                } else {
+                    trail.draw(points, tangents, point_count, draw_epoch, view_signature(), scene_w, scene_h, scene);
+                }
+                
+                // Dust changes every frame, so it goes over the cached trail uncached
+                bool gpu_dust_active = g_state.dust_gpu && gpu_dust.available();
+                if (g_state.dust && (gpu_dust_active ? gpu_dust.size() : dust.size()) > 0) {
+                    glBindFramebuffer(GL_FRAMEBUFFER, scene);
+                    glViewport(0, 0, scene_w, scene_h);
+                    dust_shader.use();
+                    dust_shader.setMat4("view", glm::value_ptr(view));
+                    dust_shader.setMat4("projection", glm::value_ptr(projection));
+                    dust_shader.setFloat("pointSize", g_state.dust_point_size * scene_w / g_state.width);
+                    dust_shader.setFloat("focusDistance", g_state.camera.distance);
+                    dust_shader.setFloat("alpha", g_state.dust_alpha);
+                    glEnable(GL_PROGRAM_POINT_SIZE);
+                    glDisable(GL_DEPTH_TEST);
+                    glBlendFunc(GL_SRC_ALPHA, GL_ONE);  // Additive: density shows as brightness
+                    if (gpu_dust_active) {
+                        gpu_dust.draw();
+                    } else {
+                        dust.draw();
+                    }
+                    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+                    glEnable(GL_DEPTH_TEST);
+                    glDisable(GL_PROGRAM_POINT_SIZE);
+                }
+                
+                // Post chain at scene resolution; the last step writes to the window
+                // unless the upscale still follows
+                GLuint texture = resolution.sceneTexture();
+                if (aa.postProcess()) {
+                    bool last = !bloom.enabled && !resolution.active();
+                    aa.apply(texture, last ? 0 : aa.outputTarget(scene_w, scene_h), scene_w, scene_h);
+                    texture = aa.outputTexture();
+                }
+                aa.timer().end();
+                if (bloom.enabled) {
+                    bool last = !resolution.active();
+                    bloom.apply(texture, last ? 0 : bloom.outputTarget(scene_w, scene_h), scene_w, scene_h);
+                    texture = bloom.outputTexture();
+                }
+                if (resolution.active()) {
+                    resolution.present(texture, g_state.width, g_state.height);
+                }
+                Framebuffer::bindDefault(g_state.width, g_state.height);
+                
+                // Timer queries cannot nest, so scene and bloom are timed separately
+                double bloom_ms = bloom.enabled ? bloom.timer().averageMs() : 0.0;
+                resolution.update(aa.timer().averageMs() + bloom_ms);
+                g_state.scene_scale = resolution.active() ? resolution.scale() : 1.0f;
+                for (int m = 0; m < static_cast<int>(AaMode::Count); ++m) {
+                    g_state.aa_cost_ms[m] = aa.timer(static_cast<AaMode>(m)).averageMs();
+                }
+                g_state.bloom_ms = bloom_ms;
+                zone.addItems(trail.segmentsDrawn());
+            }
+            
+            #ifdef HAS_IMGUI
+            // Render ImGui into the cached overlay only when something changed
+            {
+                PROFILE_ZONE("gui");
+                overlay.enabled = g_state.gui_cache;
+                overlay.refresh_interval = g_state.gui_refresh;
+                overlay.resize(g_state.width, g_state.height);
+                if (g_state.gui_input) {
+                    overlay.markInput();
+                    g_state.gui_input = false;
+                }
+                double now_s = glfwGetTime();
+                uint64_t signature = gui_signature(trajectory.size());
+                if (overlay.needsRebuild(now_s, signature)) {
+                    overlay.beginRebuild();
+                    render_gui();
+                    overlay.endRebuild(now_s, signature);
+                }
+                overlay.composite();
+                settling = overlay.settling();
+            }
+            #else
+            g_state.gui_input = false;
+            #endif
+            
+            // About to go idle: keep this frame (the back buffer is undefined after a swap)
+            if (g_state.idle_mode && !g_state.running && !g_state.gui_input && !settling) {
+                frame_copy.resize(g_state.width, g_state.height);
+                if (frame_copy.valid()) frame_copy.copyFrom(0, g_state.width, g_state.height);
+            }
+            
+            // Swap buffers
+            glfwSwapBuffers(window);
+            
+            Profiler::instance().endFrame();
+            
+            // Record frame time (swap included, so stalls show up too)
+            auto now = std::chrono::high_resolution_clock::now();
+            g_state.frame_times.record(
+                std::chrono::duration_cast<std::chrono::microseconds>(now - g_state.last_frame).count());
+            g_state.last_frame = now;
+            
+            // Update FPS
+            g_state.frame_count++;
+            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - g_state.fps_timer).count();
+            if (elapsed >= 1000) {
+                g_state.fps = g_state.frame_count / (elapsed / 1000.0);
+                g_state.frame_count = 0;
+                g_state.fps_timer = now;
+                
+                // Percentile walks are not free, so refresh them with the FPS counter
+                g_state.frame_p50 = g_state.frame_times.percentile(50.0) / 1000.0;
+                g_state.frame_p95 = g_state.frame_times.percentile(95.0) / 1000.0;
+                g_state.frame_p99 = g_state.frame_times.percentile(99.0) / 1000.0;
+                g_state.frame_max = g_state.frame_times.max() / 1000.0;
+                
+                // Update window title
+                std::string title = "Lorenz Attractor - " + 
+                                  std::to_string((int)g_state.fps) + " FPS | " +
+                                  std::to_string(trajectory.size()) + " points";
+                if (g_state.running) title += " [RUNNING]";
+                else title += " [PAUSED - Press SPACE]";
+                glfwSetWindowTitle(window, title.c_str());
+            }
+        }
+        
+        // Frame-time report
+        const HdrHistogram& ft = g_state.frame_times;
+        std::cout << "\nFrame times over " << ft.count() << " frames (ms): p50 "
+                  << ft.percentile(50.0) / 1000.0 << "  p95 " << ft.percentile(95.0) / 1000.0
+                  << "  p99 " << ft.percentile(99.0) / 1000.0 << "  max " << ft.max() / 1000.0 << std::endl;
+        std::ofstream hgrm("frame_times.hgrm");
+        if (hgrm) {
+            ft.writePercentiles(hgrm, 1000.0);
+            std::cout << "Frame-time distribution written to frame_times.hgrm" << std::endl;
         }
+        
+        memory::setTrimmer(MemTag::SolverHistory, nullptr);   // Captures the solver
+        g_state.jobs = nullptr;
+        g_state.results = nullptr;
     }
     
     // Cleanup
@@ -250,9 +754,6 @@ int main() {
     ImGui::DestroyContext();
     #endif
     
-    glDeleteVertexArrays(1, &VAO);
-    glDeleteBuffers(1, &VBO);
-    
     glfwTerminate();
     return 0;
 }
@@ -261,10 +762,17 @@ int main() {
 void framebuffer_size_callback(GLFWwindow* window, int width, int height) {
     g_state.width = width;
     g_state.height = height;
+    g_state.redraw = true;
     glViewport(0, 0, width, height);
 }
 
+void window_refresh_callback(GLFWwindow*) {
+    g_state.exposed = true;
+}
+
 void mouse_button_callback(GLFWwindow* window, int button, int action, int mods) {
+    g_state.gui_input = true;
+    
     #ifdef HAS_IMGUI
     ImGuiIO& io = ImGui::GetIO();
     if (io.WantCaptureMouse) return;
@@ -285,6 +793,8 @@ void mouse_button_callback(GLFWwindow* window, int button, int action, int mods)
 }
 
 void cursor_position_callback(GLFWwindow* window, double xpos, double ypos) {
+    g_state.gui_input = true;
+    
     #ifdef HAS_IMGUI
     ImGuiIO& io = ImGui::GetIO();
     if (io.WantCaptureMouse) return;
@@ -315,6 +825,8 @@ void cursor_position_callback(GLFWwindow* window, double xpos, double ypos) {
 }
 
 void scroll_callback(GLFWwindow* window, double xoffset, double yoffset) {
+    g_state.gui_input = true;
+    
     #ifdef HAS_IMGUI
     ImGuiIO& io = ImGui::GetIO();
     if (io.WantCaptureMouse) return;
@@ -324,6 +836,8 @@ void scroll_callback(GLFWwindow* window, double xoffset, double yoffset) {
 }
 
 void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods) {
+    g_state.gui_input = true;
+    
     if (action == GLFW_PRESS) {
         switch (key) {
             case GLFW_KEY_SPACE:
@@ -340,6 +854,110 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
     }
 }
 
+// Analysis inputs taken from the current parameters; the rest stay at their defaults
+BifurcationSettings bifurcation_settings() {
+    BifurcationSettings settings;
+    settings.sigma = g_state.sigma;
+    settings.beta = g_state.beta;
+    return settings;
+}
+
+LyapunovSettings lyapunov_settings() {
+    LyapunovSettings settings;
+    settings.params = {g_state.sigma, g_state.rho, g_state.beta};
+    settings.dt = g_state.dt;
+    return settings;
+}
+
+// FNV-1a over the bytes of `count` doubles
+uint64_t hash_values(const double* values, size_t count) {
+    uint64_t hash = 1469598103934665603ull;
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(values);
+    for (size_t i = 0; i < count * sizeof(double); ++i) {
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
+    }
+    return hash;
+}
+
+// Hash of the discrete values render_gui() displays; a change forces an overlay
+// rebuild. Readouts that move every frame while the simulation runs (fps, frame
+// time percentiles, live memory, profiler zones) follow the refresh interval.
+uint64_t gui_signature(size_t trajectory_points) {
+    double values[] = {
+        g_state.camera.distance, g_state.camera.yaw, g_state.camera.pitch,
+        static_cast<double>(g_state.running), static_cast<double>(trajectory_points > 0),
+        g_state.scene_scale, static_cast<double>(g_state.aa_mode), static_cast<double>(g_state.tube_sides),
+        static_cast<double>(g_state.bifurcation.revision()), static_cast<double>(g_state.lyapunov.revision()),
+    };
+    uint64_t signature = hash_values(values, sizeof(values) / sizeof(values[0]));
+    if (g_state.jobs) {
+        for (const JobScheduler::Info& job : g_state.jobs->jobs()) {
+            // Whole percents: the bar cannot show finer steps
+            double progress[] = {static_cast<double>(signature), static_cast<double>(job.id),
+                                 std::floor(job.progress * 100.0)};
+            signature = hash_values(progress, 3);
+        }
+    }
+    return signature;
+}
+
+// Inputs to the line shader's uniforms; a change redraws the whole cached trail
+uint64_t view_signature() {
+    double values[] = {
+        static_cast<double>(g_state.camera.getRevision()), g_state.line_alpha,
+        static_cast<double>(g_state.width), static_cast<double>(g_state.height),
+        static_cast<double>(g_state.aa_mode),
+        g_state.dt, static_cast<double>(g_state.sample_stride), g_state.spline_pixels,
+        static_cast<double>(g_state.tube), g_state.tube_radius, static_cast<double>(g_state.tube_sides),
+    };
+    return hash_values(values, sizeof(values) / sizeof(values[0]));
+}
+
+// Everything the rendered scene depends on; unchanged means the last frame is still valid
+uint64_t scene_signature(const LorenzSolver& solver) {
+    double values[] = {
+        static_cast<double>(g_state.camera.getRevision()),
+        static_cast<double>(solver.getRevision()),
+        g_state.line_alpha, static_cast<double>(g_state.max_points),
+        static_cast<double>(g_state.width), static_cast<double>(g_state.height),
+        static_cast<double>(g_state.dust), g_state.dust_point_size, g_state.dust_alpha,
+        static_cast<double>(g_state.scrubbing), g_state.timeline_position,
+        static_cast<double>(g_state.timeline_span),
+    };
+    return hash_values(values, sizeof(values) / sizeof(values[0]));
+}
+
+// Seed a cloud, step it for a number of frames with a CPU cross-check after
+// every dispatch, and fail on any mismatch
+int run_compute_check(int argc, char** argv) {
+    int particles = arg_int(argc, argv, "--particles", 100000);
+    int frames = arg_int(argc, argv, "--frames", 100);
+    int steps = arg_int(argc, argv, "--steps", 4);
+    
+    std::cout << "OpenGL Version: " << glGetString(GL_VERSION) << std::endl;
+    std::cout << "GPU: " << glGetString(GL_RENDERER) << std::endl;
+    
+    GpuEnsemble ensemble;
+    if (!ensemble.available()) {
+        std::cerr << "Compute-shader ensemble unavailable" << std::endl;
+        return 2;
+    }
+    ensemble.check_interval = 1;
+    ensemble.seed(particles, glm::vec3(0.0f, 1.0f, 0.0f), 1.0f);
+    
+    LorenzSolver solver;
+    for (int f = 0; f < frames; ++f) {
+        ensemble.advance(solver.getParameters(), 0.01f, steps);
+    }
+    glFinish();
+    
+    const GpuEnsemble::CheckStats& checks = ensemble.checkStats();
+    std::cout << "Compute check: " << ensemble.size() << " particles, " << frames << " x "
+              << steps << " steps, " << checks.checks - checks.failures << "/" << checks.checks
+              << " checks passed, max relative error " << checks.max_error << std::endl;
+    return checks.failures == 0 && checks.checks > 0 ? 0 : 1;
+}
+
 void render_gui() {
     #ifdef HAS_IMGUI
     ImGui_ImplOpenGL3_NewFrame();
@@ -352,6 +970,13 @@ void render_gui() {
     ImGui::Begin("Lorenz Controls");
     
     ImGui::Text("FPS: %.1f", g_state.fps);
+    ImGui::Text("Frame ms  p50 %.2f  p95 %.2f  p99 %.2f  max %.2f",
+                g_state.frame_p50, g_state.frame_p95, g_state.frame_p99, g_state.frame_max);
+    ImGui::SameLine();
+    if (ImGui::Button("Reset##frametimes")) {
+        g_state.frame_times.reset();
+    }
+    ImGui::Text("SIMD: %s", kernels::pathName(kernels::activePath()));
     ImGui::Separator();
     
     ImGui::Text("Simulation");
@@ -364,6 +989,18 @@ void render_gui() {
     }
     
     ImGui::SliderInt("Steps/Frame", &g_state.steps_per_frame, 1, 20);
+    
+    // Position and span choose what is replayed from the checkpoints
+    ImGui::Text("Timeline: %llu steps, %zu checkpoints (%.1f KB)", g_state.timeline_steps,
+                g_state.timeline_checkpoints, g_state.timeline_bytes / 1024.0);
+    ImGui::Checkbox("Scrub Timeline", &g_state.scrubbing);
+    if (g_state.scrubbing) {
+        ImGui::SliderFloat("Position", &g_state.timeline_position, 0.0f, 1.0f, "%.4f");
+        ImGui::SliderInt("Span (steps)", &g_state.timeline_span, 1000, 10000000, "%d",
+                         ImGuiSliderFlags_Logarithmic);
+        ImGui::Text("Replay %.2f ms: %zu cached, %zu integrated chunks", g_state.timeline_replay_ms,
+                    g_state.timeline_hits, g_state.timeline_misses);
+    }
     ImGui::Separator();
     
     ImGui::Text("Lorenz Parameters");
@@ -373,9 +1010,201 @@ void render_gui() {
     ImGui::SliderFloat("dt", &g_state.dt, 0.001f, 0.05f, "%.4f");
     ImGui::Separator();
     
+    // Both analyses use the current sigma/beta (and rho, dt for the exponent)
+    ImGui::Text("Analysis");
+    ImGui::SliderFloat("Budget (ms/frame)", &g_state.analysis_budget_ms, 0.5f, 12.0f, "%.1f");
+    ImGui::Checkbox("Run On Worker", &g_state.analysis_on_worker);
+    if (ImGui::Button("Bifurcation Sweep")) {
+        BifurcationSettings settings = bifurcation_settings();
+        if (!loadCached(*g_state.results, settings, g_state.bifurcation)) {
+            g_state.jobs->start("Bifurcation", [settings](JobContext& ctx) {
+                return bifurcationSweep(ctx, settings, g_state.bifurcation, g_state.results);
+            }, g_state.analysis_on_worker);
+        }
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Lyapunov Exponent")) {
+        LyapunovSettings settings = lyapunov_settings();
+        if (!loadCached(*g_state.results, settings, g_state.lyapunov)) {
+            g_state.jobs->start("Lyapunov", [settings](JobContext& ctx) {
+                return largestLyapunov(ctx, settings, g_state.lyapunov, g_state.results);
+            }, g_state.analysis_on_worker);
+        }
+    }
+    for (const JobScheduler::Info& job : g_state.jobs->jobs()) {
+        ImGui::PushID(job.id);
+        char label[64];
+        snprintf(label, sizeof(label), "%s%s %.0f%%", job.name.c_str(), job.on_worker ? " (worker)" : "",
+                 job.progress * 100.0f);
+        ImGui::ProgressBar(job.progress, ImVec2(250, 0), label);
+        ImGui::SameLine();
+        if (ImGui::Button("Cancel")) {
+            g_state.jobs->cancel(job.id);
+        }
+        ImGui::PopID();
+    }
+    if (auto sweep = g_state.bifurcation.get()) {
+        // z maxima against rho, one dot per maximum
+        const BifurcationSettings& settings = sweep->settings;
+        float z_max = 1.0f;
+        for (const glm::vec2& point : sweep->points) z_max = std::max(z_max, point.y);
+        ImVec2 origin = ImGui::GetCursorScreenPos();
+        ImVec2 size(320, 160);
+        ImDrawList* draw = ImGui::GetWindowDrawList();
+        draw->AddRectFilled(origin, ImVec2(origin.x + size.x, origin.y + size.y), IM_COL32(15, 15, 25, 255));
+        for (const glm::vec2& point : sweep->points) {
+            float x = origin.x + (point.x - settings.rho_min) / (settings.rho_max - settings.rho_min) * (size.x - 1);
+            float y = origin.y + (1.0f - point.y / z_max) * (size.y - 1);
+            draw->AddRectFilled(ImVec2(x, y), ImVec2(x + 1, y + 1), IM_COL32(120, 200, 255, 160));
+        }
+        ImGui::Dummy(size);
+        ImGui::Text("rho %.0f..%.0f, z max up to %.1f (%zu points)", settings.rho_min, settings.rho_max,
+                    z_max, sweep->points.size());
+    }
+    if (auto exponent = g_state.lyapunov.get()) {
+        const LorenzParams& params = exponent->settings.params;
+        ImGui::Text("Largest Lyapunov exponent %.4f", exponent->exponent);
+        ImGui::TextDisabled("  sigma %.2f rho %.2f beta %.3f, dt %.4f", params.sigma, params.rho, params.beta,
+                            exponent->settings.dt);
+        ImGui::PlotLines("Convergence", exponent->convergence.data(), static_cast<int>(exponent->convergence.size()),
+                         0, nullptr, 3.4e38f, 3.4e38f, ImVec2(250, 60));
+    }
+    ImGui::Text("Result cache: %zu entries, %.2f / %d MB (%zu hits, %zu misses)", g_state.results->entries(),
+                g_state.results->bytes() / 1048576.0, g_state.cache_limit_mb, g_state.results->hits(),
+                g_state.results->misses());
+    if (ImGui::SliderInt("Cache Limit (MB)", &g_state.cache_limit_mb, 1, 4096, "%d", ImGuiSliderFlags_Logarithmic)) {
+        g_state.results->setLimit(static_cast<size_t>(g_state.cache_limit_mb) << 20);
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Clear##cache")) {
+        g_state.results->clear();
+    }
+    ImGui::Separator();
+    
     ImGui::Text("Visualization");
     ImGui::SliderInt("Max Points", &g_state.max_points, 1000, 200000);
     ImGui::SliderFloat("Line Alpha", &g_state.line_alpha, 0.1f, 1.0f);
+    ImGui::Checkbox("Incremental Trail", &g_state.incremental_trail);
+    int primitive = static_cast<int>(g_state.trail_primitive);
+    const char* primitives[] = {"Lines", "Tessellated spline", "Instanced spline"};
+    ImGui::Combo("Trail", &primitive, primitives, 3);
+    g_state.trail_primitive = static_cast<TrailPrimitive>(primitive);
+    if (g_state.trail_primitive != TrailPrimitive::Lines) {
+        ImGui::SliderInt("Sample Stride", &g_state.sample_stride, 1, 32);
+        ImGui::SliderFloat("Pixels/Sub-segment", &g_state.spline_pixels, 1.0f, 16.0f, "%.1f");
+    } else {
+        g_state.sample_stride = 1;
+    }
+    ImGui::Checkbox("Lit Tube", &g_state.tube);
+    if (g_state.tube) {
+        ImGui::SameLine();
+        ImGui::Text("%d sides", g_state.tube_sides);
+        ImGui::SliderFloat("Tube Radius", &g_state.tube_radius, 0.05f, 1.5f, "%.2f");
+    }
+    if (ImGui::Checkbox("Dust Cloud", &g_state.dust) && g_state.dust) {
+        g_state.dust_reseed = true;
+    }
+    if (g_state.dust) {
+        ImGui::SameLine();
+        ImGui::Text("%.2f ms", g_state.dust_ms);
+        int exponent = static_cast<int>(std::lround(std::log10(static_cast<double>(g_state.dust_particles))));
+        const char* counts[] = {"10^5", "10^6", "10^7"};
+        int choice = std::min(std::max(exponent - 5, 0), 2);
+        if (ImGui::Combo("Particles", &choice, counts, 3)) {
+            g_state.dust_particles = static_cast<int>(std::pow(10.0, choice + 5));
+        }
+        if (ImGui::SliderFloat("Seed Radius", &g_state.dust_radius, 0.01f, 5.0f, "%.2f",
+                               ImGuiSliderFlags_Logarithmic)) {
+            g_state.dust_reseed = true;
+        }
+        if (g_state.compute_available) {
+            if (ImGui::Checkbox("GPU Compute", &g_state.dust_gpu)) {
+                g_state.dust_reseed = true;
+            }
+            if (g_state.dust_gpu) {
+                const GpuEnsemble::CheckStats& checks = g_state.dust_checks;
+                ImGui::SameLine();
+                ImGui::Text("CPU check %lu/%lu ok, max err %.1e", checks.checks - checks.failures,
+                            checks.checks, checks.max_error);
+            }
+        }
+        ImGui::SliderFloat("Point Size", &g_state.dust_point_size, 1.0f, 8.0f, "%.1f");
+        ImGui::SliderFloat("Dust Alpha", &g_state.dust_alpha, 0.01f, 1.0f, "%.2f");
+        if (ImGui::Button("Reseed at Trail Head")) {
+            g_state.dust_reseed = true;
+        }
+    }
+    ImGui::Checkbox("Order-Independent Transparency", &g_state.weighted_oit);
+    if (g_state.weighted_oit && g_state.aa_mode == AaMode::Msaa) {
+        ImGui::SameLine();
+        ImGui::TextDisabled("(single-sample)");
+    }
+    ImGui::Checkbox("Dynamic Resolution", &g_state.dynamic_resolution);
+    ImGui::SameLine();
+    ImGui::Text("%.0f%%  scene GPU %.2f ms", g_state.scene_scale * 100.0f,
+                g_state.aa_cost_ms[static_cast<int>(g_state.aa_mode)]);
+    ImGui::SliderFloat("Scene Budget (ms)", &g_state.scene_budget_ms, 1.0f, 33.0f, "%.1f");
+    ImGui::SliderFloat("Min Scale", &g_state.min_scene_scale, 0.25f, 1.0f, "%.2f");
+    ImGui::SliderFloat("Sharpness", &g_state.upscale_sharpness, 0.0f, 1.0f, "%.2f");
+    
+    // Cost is the whole scene pass under each mode, measured while it was active
+    int aa_mode = static_cast<int>(g_state.aa_mode);
+    for (int m = 0; m < static_cast<int>(AaMode::Count); ++m) {
+        if (m > 0) ImGui::SameLine();
+        ImGui::RadioButton(AntiAliasing::modeName(static_cast<AaMode>(m)), &aa_mode, m);
+    }
+    g_state.aa_mode = static_cast<AaMode>(aa_mode);
+    if (g_state.aa_mode == AaMode::Msaa) {
+        ImGui::SliderInt("MSAA Samples", &g_state.msaa_samples, 2, 8);
+    }
+    for (int m = 0; m < static_cast<int>(AaMode::Count); ++m) {
+        if (g_state.aa_cost_ms[m] > 0.0) {
+            ImGui::Text("%-15s %6.3f ms", AntiAliasing::modeName(static_cast<AaMode>(m)), g_state.aa_cost_ms[m]);
+        }
+    }
+    
+    ImGui::Checkbox("Bloom", &g_state.bloom);
+    if (g_state.bloom) {
+        ImGui::SameLine();
+        ImGui::Text("%.3f ms", g_state.bloom_ms);
+        ImGui::SliderFloat("Bloom Threshold", &g_state.bloom_threshold, 0.0f, 1.0f, "%.2f");
+        ImGui::SliderFloat("Bloom Intensity", &g_state.bloom_intensity, 0.0f, 3.0f, "%.2f");
+    }
+    ImGui::Separator();
+    
+    ImGui::Text("Memory (live / peak)");
+    for (int t = 0; t < static_cast<int>(MemTag::Count); ++t) {
+        MemTag tag = static_cast<MemTag>(t);
+        ImGui::Text("%-15s %8.2f / %8.2f MB", memory::tagName(tag),
+                    memory::live(tag) / 1048576.0, memory::peak(tag) / 1048576.0);
+    }
+    ImGui::SliderInt("History Budget (MB)", &g_state.history_budget_mb, 0, 64);
+    ImGui::Separator();
+    
+    ImGui::Text("Profiler (per frame)");
+    if (ImGui::Checkbox("HW Counters", &g_state.hw_counters)) {
+        Profiler::instance().enableCounters(g_state.hw_counters);
+    }
+    if (g_state.hw_counters && !Profiler::instance().countersAvailable()) {
+        ImGui::SameLine();
+        ImGui::TextDisabled("(perf_event_open unavailable)");
+    }
+    ImGui::Text("Frame tasks %.3f ms, critical path %.3f ms", g_state.frame_graph_ms, g_state.critical_path_ms);
+    ImGui::TextDisabled("  %s", g_state.critical_path.c_str());
+    for (const ZoneStats& zone : Profiler::instance().snapshot()) {
+        ImGui::Text("%-9s %7.3f ms", zone.name.c_str(), zone.seconds * 1000.0);
+        if (zone.has_hw) {
+            ImGui::SameLine();
+            ImGui::Text("IPC %.2f  L3 miss/item %.3f  br miss/item %.3f", zone.ipc(),
+                        zone.perItem(zone.hw.cache_misses), zone.perItem(zone.hw.branch_misses));
+        }
+    }
+    ImGui::Separator();
+    
+    ImGui::Text("GUI Overlay");
+    ImGui::Checkbox("Cache GUI Texture", &g_state.gui_cache);
+    ImGui::SliderFloat("GUI Refresh (s)", &g_state.gui_refresh, 0.05f, 2.0f, "%.2f");
+    ImGui::Checkbox("Idle When Unchanged", &g_state.idle_mode);
     ImGui::Separator();
     
     ImGui::Text("Camera");
@@ -0,0 +1,108 @@
+// memory_tracker.cpp - Per-subsystem memory accounting implementation
+#include "memory_tracker.h"
+#include <atomic>
+#include <string>
+
+#include "metrics.h"
+
+namespace {
+
+constexpr int kTagCount = static_cast<int>(MemTag::Count);
+
+struct Counters {
+    std::atomic<size_t> live{0};
+    std::atomic<size_t> peak{0};
+    std::atomic<size_t> budget{0};
+    std::function<void(size_t)> trimmer;   // Main thread only
+};
+
+Counters& counters(MemTag tag) {
+    static Counters table[kTagCount];
+    return table[static_cast<int>(tag)];
+}
+
+} // namespace
+
+namespace memory {
+
+void add(MemTag tag, size_t bytes) {
+    Counters& c = counters(tag);
+    size_t now = c.live.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    size_t peak = c.peak.load(std::memory_order_relaxed);
+    while (now > peak && !c.peak.compare_exchange_weak(peak, now, std::memory_order_relaxed)) {
+    }
+}
+
+void sub(MemTag tag, size_t bytes) {
+    counters(tag).live.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+void replace(MemTag tag, size_t old_bytes, size_t new_bytes) {
+    if (new_bytes > old_bytes) add(tag, new_bytes - old_bytes);
+    else if (old_bytes > new_bytes) sub(tag, old_bytes - new_bytes);
+}
+
+size_t live(MemTag tag) {
+    return counters(tag).live.load(std::memory_order_relaxed);
+}
+
+size_t peak(MemTag tag) {
+    return counters(tag).peak.load(std::memory_order_relaxed);
+}
+
+size_t totalLive() {
+    size_t total = 0;
+    for (int t = 0; t < kTagCount; ++t) total += live(static_cast<MemTag>(t));
+    return total;
+}
+
+const char* tagName(MemTag tag) {
+    switch (tag) {
+        case MemTag::SolverHistory: return "solver_history";
+        case MemTag::Ensemble:      return "ensemble";
+        case MemTag::Analysis:      return "analysis";
+        case MemTag::RenderStaging: return "render_staging";
+        case MemTag::GpuBuffers:    return "gpu_buffers";
+        case MemTag::OutputStaging: return "output_staging";
+        case MemTag::Count:         break;
+    }
+    return "unknown";
+}
+
+void setBudget(MemTag tag, size_t bytes) {
+    counters(tag).budget.store(bytes, std::memory_order_relaxed);
+}
+
+size_t budget(MemTag tag) {
+    return counters(tag).budget.load(std::memory_order_relaxed);
+}
+
+void setTrimmer(MemTag tag, std::function<void(size_t)> trimmer) {
+    counters(tag).trimmer = std::move(trimmer);
+}
+
+void enforceBudgets() {
+    for (int t = 0; t < kTagCount; ++t) {
+        Counters& c = counters(static_cast<MemTag>(t));
+        size_t limit = c.budget.load(std::memory_order_relaxed);
+        if (limit && c.trimmer && c.live.load(std::memory_order_relaxed) > limit) {
+            c.trimmer(limit);
+        }
+    }
+}
+
+} // namespace memory
+
+void memory::exportMetrics() {
+    MetricsRegistry& registry = MetricsRegistry::instance();
+    for (int t = 0; t < kTagCount; ++t) {
+        MemTag tag = static_cast<MemTag>(t);
+        std::string labels = std::string("subsystem=\"") + tagName(tag) + "\"";
+        registry.callback("lorenz_memory_live_bytes", "Bytes currently allocated per subsystem",
+                          labels.c_str(), [tag]() { return static_cast<double>(live(tag)); });
+        registry.callback("lorenz_memory_peak_bytes", "Peak bytes allocated per subsystem",
+                          labels.c_str(), [tag]() { return static_cast<double>(peak(tag)); });
+        registry.callback("lorenz_memory_budget_bytes", "Budget per subsystem (0 = none)",
+                          labels.c_str(), [tag]() { return static_cast<double>(budget(tag)); });
+    }
+}
@@ -0,0 +1,72 @@
+// metrics.cpp - Metrics registry and Prometheus exposition
+#include "metrics.h"
+#include <cstdio>
+#include <vector>
+
+MetricsRegistry& MetricsRegistry::instance() {
+    static MetricsRegistry registry;
+    return registry;
+}
+
+MetricsRegistry::Entry& MetricsRegistry::add(const char* name, const char* help,
+                                             const char* labels, Kind kind) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& entry : entries_) {
+        if (entry.name == name && entry.labels == labels) return entry;
+    }
+    entries_.emplace_back();
+    Entry& entry = entries_.back();
+    entry.name = name;
+    entry.help = help;
+    entry.labels = labels;
+    entry.kind = kind;
+    return entry;
+}
+
+Counter& MetricsRegistry::counter(const char* name, const char* help, const char* labels) {
+    return add(name, help, labels, Kind::Counter).counter;
+}
+
+Gauge& MetricsRegistry::gauge(const char* name, const char* help, const char* labels) {
+    return add(name, help, labels, Kind::Gauge).gauge;
+}
+
+void MetricsRegistry::callback(const char* name, const char* help, const char* labels,
+                               std::function<double()> read) {
+    Entry& entry = add(name, help, labels, Kind::Callback);
+    std::lock_guard<std::mutex> lock(mutex_);
+    entry.read = std::move(read);
+}
+
+std::string MetricsRegistry::exposition() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::string out;
+    char line[512];
+
+    // Samples sharing a name are grouped under one HELP/TYPE header
+    std::vector<bool> written(entries_.size(), false);
+    for (size_t i = 0; i < entries_.size(); ++i) {
+        if (written[i]) continue;
+        const Entry& head = entries_[i];
+        const char* type = head.kind == Kind::Counter ? "counter" : "gauge";
+        out += "# HELP " + head.name + " " + head.help + "\n";
+        out += "# TYPE " + head.name + " " + type + "\n";
+
+        for (size_t j = i; j < entries_.size(); ++j) {
+            const Entry& e = entries_[j];
+            if (written[j] || e.name != head.name) continue;
+            written[j] = true;
+
+            std::string series = e.labels.empty() ? e.name : e.name + "{" + e.labels + "}";
+            if (e.kind == Kind::Counter) {
+                std::snprintf(line, sizeof(line), "%s %llu\n", series.c_str(),
+                              static_cast<unsigned long long>(e.counter.value.load(std::memory_order_relaxed)));
+            } else {
+                double v = e.kind == Kind::Gauge ? e.gauge.get() : (e.read ? e.read() : 0.0);
+                std::snprintf(line, sizeof(line), "%s %.9g\n", series.c_str(), v);
+            }
+            out += line;
+        }
+    }
+    return out;
+}
@@ -0,0 +1,107 @@
+// metrics_server.cpp - Minimal localhost HTTP listener serving /metrics
+#include "metrics_server.h"
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include "metrics.h"
+
+#ifdef __linux__
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+MetricsServer::MetricsServer(int port)
+    : port_(port)
+{
+}
+
+MetricsServer::~MetricsServer() {
+    stop();
+}
+
+bool MetricsServer::start() {
+    #ifdef __linux__
+    listen_fd_ = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listen_fd_ < 0) return false;
+
+    int reuse = 1;
+    setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port_));
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);   // Never exposed off-host
+
+    if (bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        listen(listen_fd_, 8) != 0) {
+        std::cerr << "Metrics: cannot listen on 127.0.0.1:" << port_
+                  << " (" << std::strerror(errno) << ")" << std::endl;
+        close(listen_fd_);
+        listen_fd_ = -1;
+        return false;
+    }
+
+    running_ = true;
+    thread_ = std::thread(&MetricsServer::serve, this);
+    std::cout << "Metrics: http://127.0.0.1:" << port_ << "/metrics" << std::endl;
+    return true;
+    #else
+    std::cerr << "Metrics endpoint is only available on Linux" << std::endl;
+    return false;
+    #endif
+}
+
+void MetricsServer::stop() {
+    if (!running_.exchange(false)) return;
+    if (thread_.joinable()) thread_.join();
+    #ifdef __linux__
+    close(listen_fd_);
+    #endif
+    listen_fd_ = -1;
+}
+
+void MetricsServer::serve() {
+    #ifdef __linux__
+    while (running_) {
+        // Wake up regularly so stop() never waits long
+        pollfd pfd{listen_fd_, POLLIN, 0};
+        if (poll(&pfd, 1, 200) <= 0) continue;
+
+        int client = accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (client < 0) continue;
+
+        // A scraper sends a short GET; the first line is all we need
+        char request[2048];
+        pollfd cfd{client, POLLIN, 0};
+        ssize_t got = poll(&cfd, 1, 1000) > 0 ? recv(client, request, sizeof(request) - 1, 0) : 0;
+        request[got > 0 ? got : 0] = '\0';
+
+        std::string status = "200 OK";
+        std::string body;
+        if (std::strncmp(request, "GET /metrics", 12) == 0 || std::strncmp(request, "GET / ", 6) == 0) {
+            body = MetricsRegistry::instance().exposition();
+        } else {
+            status = "404 Not Found";
+            body = "try /metrics\n";
+        }
+
+        std::string response = "HTTP/1.1 " + status + "\r\n"
+            "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+            "Content-Length: " + std::to_string(body.size()) + "\r\n"
+            "Connection: close\r\n\r\n" + body;
+        size_t sent = 0;
+        while (sent < response.size()) {
+            ssize_t n = send(client, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+            if (n <= 0) break;
+            sent += n;
+        }
+        close(client);
+    }
+    #endif
+}
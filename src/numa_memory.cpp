@@ -0,0 +1,123 @@
+// numa_memory.cpp - Huge-page allocation and NUMA topology implementation
+#include "numa_memory.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace {
+
+// Parse a kernel cpulist such as "0-7,16-23"
+std::vector<int> parse_cpulist(const std::string& text) {
+    std::vector<int> cpus;
+    std::stringstream ss(text);
+    std::string range;
+    while (std::getline(ss, range, ',')) {
+        if (range.empty() || range == "\n") continue;
+        size_t dash = range.find('-');
+        int first = std::atoi(range.c_str());
+        int last = dash == std::string::npos ? first : std::atoi(range.c_str() + dash + 1);
+        for (int cpu = first; cpu <= last; ++cpu) cpus.push_back(cpu);
+    }
+    return cpus;
+}
+
+NumaTopology detect_topology() {
+    NumaTopology topology;
+    #ifdef __linux__
+    for (int node = 0; node < 1024; ++node) {
+        std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+        if (!file) break;
+        std::string line;
+        std::getline(file, line);
+        std::vector<int> cpus = parse_cpulist(line);
+        if (!cpus.empty()) topology.node_cpus.push_back(cpus);
+    }
+    #endif
+    if (topology.node_cpus.empty()) {
+        std::vector<int> cpus;
+        int count = std::max(1u, std::thread::hardware_concurrency());
+        for (int cpu = 0; cpu < count; ++cpu) cpus.push_back(cpu);
+        topology.node_cpus.push_back(cpus);
+    }
+    return topology;
+}
+
+} // namespace
+
+const NumaTopology& NumaTopology::get() {
+    static const NumaTopology topology = detect_topology();
+    return topology;
+}
+
+void* huge_alloc(size_t bytes, bool explicit_huge, PageBacking* backing) {
+    if (bytes == 0) return nullptr;
+    #ifdef __linux__
+    size_t rounded = (bytes + kHugePageSize - 1) & ~(kHugePageSize - 1);
+
+    #ifdef MAP_HUGETLB
+    if (explicit_huge) {
+        void* ptr = mmap(nullptr, rounded, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (ptr != MAP_FAILED) {
+            if (backing) *backing = PageBacking::Explicit;
+            return ptr;
+        }
+    }
+    #endif
+
+    // Over-map by one huge page so the block can start on a 2 MB boundary,
+    // which is what lets the kernel back it with transparent huge pages
+    size_t mapped = rounded + kHugePageSize;
+    char* raw = static_cast<char*>(mmap(nullptr, mapped, PROT_READ | PROT_WRITE,
+                                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    if (raw == MAP_FAILED) return nullptr;
+
+    uintptr_t addr = reinterpret_cast<uintptr_t>(raw);
+    uintptr_t aligned = (addr + kHugePageSize - 1) & ~(uintptr_t)(kHugePageSize - 1);
+    size_t head = aligned - addr;
+    size_t tail = mapped - head - rounded;
+    if (head) munmap(raw, head);
+    if (tail) munmap(reinterpret_cast<char*>(aligned) + rounded, tail);
+
+    void* ptr = reinterpret_cast<void*>(aligned);
+    bool transparent = false;
+    #ifdef MADV_HUGEPAGE
+    transparent = madvise(ptr, rounded, MADV_HUGEPAGE) == 0;
+    #endif
+    if (backing) *backing = transparent ? PageBacking::Transparent : PageBacking::Small;
+    return ptr;
+    #else
+    (void)explicit_huge;
+    if (backing) *backing = PageBacking::Small;
+    size_t rounded = (bytes + kSmallPageSize - 1) & ~(kSmallPageSize - 1);
+    return std::aligned_alloc(kSmallPageSize, rounded);
+    #endif
+}
+
+void huge_free(void* ptr, size_t bytes) {
+    if (!ptr) return;
+    #ifdef __linux__
+    size_t rounded = (bytes + kHugePageSize - 1) & ~(kHugePageSize - 1);
+    munmap(ptr, rounded);
+    #else
+    (void)bytes;
+    std::free(ptr);
+    #endif
+}
+
+const char* backing_name(PageBacking backing) {
+    switch (backing) {
+        case PageBacking::Explicit:    return "hugetlb 2MB";
+        case PageBacking::Transparent: return "THP 2MB";
+        case PageBacking::Small:       return "4KB";
+    }
+    return "unknown";
+}
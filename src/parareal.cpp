@@ -0,0 +1,181 @@
+// parareal.cpp - Parareal parallel-in-time integration implementation
+#include "parareal.h"
+#include <algorithm>
+#include <chrono>
+#include <cfloat>
+#include <cmath>
+#include <thread>
+
+namespace {
+
+using Clock = std::chrono::high_resolution_clock;
+
+double seconds_since(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Split [begin, end) into one contiguous chunk per std::thread and run fn(b, e)
+template <typename Fn>
+void parallel_chunks(int begin, int end, int threads, Fn fn) {
+    int count = end - begin;
+    threads = std::max(1, std::min(threads, count));
+    if (threads == 1) {
+        fn(begin, end);
+        return;
+    }
+
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    for (int t = 0; t < threads; ++t) {
+        int b = begin + count * t / threads;
+        int e = begin + count * (t + 1) / threads;
+        workers.emplace_back([=, &fn]() { fn(b, e); });
+    }
+    for (auto& w : workers) w.join();
+}
+
+} // namespace
+
+Parareal::Parareal(const LorenzSolver& system, const PararealConfig& config)
+    : system_(system)
+    , config_(config)
+{
+    config_.slices = std::max(1, config_.slices);
+    if (config_.threads <= 0) {
+        config_.threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // Both propagators cover exactly one slice; dt is nudged so the step count is whole
+    float slice_time = config_.t_end / config_.slices;
+    coarse_steps_ = std::max(1L, std::lround(slice_time / config_.coarse_dt));
+    fine_steps_ = std::max(1L, std::lround(slice_time / config_.fine_dt));
+    config_.coarse_dt = slice_time / coarse_steps_;
+    config_.fine_dt = slice_time / fine_steps_;
+}
+
+glm::vec3 Parareal::coarse(const glm::vec3& state) const {
+    return system_.integrate(state, config_.coarse_dt, coarse_steps_);
+}
+
+glm::vec3 Parareal::fine(const glm::vec3& state) const {
+    return system_.integrate(state, config_.fine_dt, fine_steps_);
+}
+
+void Parareal::fineBatch(const std::vector<glm::vec3>& in, std::vector<glm::vec3>& out,
+                         int begin, int end) const {
+    // Slices are independent, so each thread steps its chunk as one SIMD batch
+    LorenzParams params = system_.getParameters();
+    parallel_chunks(begin, end, config_.threads, [&](int b, int e) {
+        std::vector<float> x(e - b), y(e - b), z(e - b);
+        for (int n = b; n < e; ++n) {
+            x[n - b] = in[n].x;
+            y[n - b] = in[n].y;
+            z[n - b] = in[n].z;
+        }
+        kernels::rk4Batch(x.data(), y.data(), z.data(), e - b, params, config_.fine_dt, fine_steps_);
+        for (int n = b; n < e; ++n) {
+            out[n] = glm::vec3(x[n - b], y[n - b], z[n - b]);
+        }
+    });
+}
+
+PararealResult Parareal::run(const glm::vec3& initial) const {
+    const int n_slices = config_.slices;
+    PararealResult result;
+
+    // Serial reference: the fine propagator alone, slice after slice
+    auto serial_start = Clock::now();
+    glm::vec3 serial_state = initial;
+    for (int n = 0; n < n_slices; ++n) {
+        serial_state = fine(serial_state);
+    }
+    result.serial_seconds = seconds_since(serial_start);
+
+    auto start = Clock::now();
+
+    // Initial prediction from the coarse propagator
+    std::vector<glm::vec3> U(n_slices + 1);
+    std::vector<glm::vec3> G(n_slices);   // G(U_n) from the previous iteration
+    std::vector<glm::vec3> F(n_slices);
+    U[0] = initial;
+    for (int n = 0; n < n_slices; ++n) {
+        G[n] = coarse(U[n]);
+        U[n + 1] = G[n];
+    }
+
+    // After k iterations the first k slices are exact, so the loop always terminates
+    int max_iterations = std::min(config_.max_iterations, n_slices);
+    for (int k = 0; k < max_iterations; ++k) {
+        fineBatch(U, F, k, n_slices);
+
+        // Sequential correction sweep: U_{n+1} = G(U_n^new) + F(U_n^old) - G(U_n^old)
+        std::vector<glm::vec3> next = U;
+        float max_update = 0.0f;
+        for (int n = k; n < n_slices; ++n) {
+            glm::vec3 updated;
+            if (next[n] == U[n]) {
+                // Unchanged start point: the correction cancels exactly, take F as-is
+                updated = F[n];
+            } else {
+                glm::vec3 g = coarse(next[n]);
+                updated = g + F[n] - G[n];
+                G[n] = g;
+            }
+            max_update = std::max(max_update, glm::length(updated - U[n + 1]));
+            next[n + 1] = updated;
+        }
+        U.swap(next);
+
+        result.iterations = k + 1;
+        result.iteration_updates.push_back(max_update);
+        if (max_update < config_.tolerance) {
+            result.converged = true;
+            break;
+        }
+    }
+    if (result.iterations == n_slices) {
+        result.converged = true;
+    }
+
+    result.parareal_seconds = seconds_since(start);
+    result.speedup = result.serial_seconds / std::max(result.parareal_seconds, 1e-9);
+    result.error_vs_serial = glm::length(U[n_slices] - serial_state);
+    result.boundaries = U;
+
+    // Chaos bound: a perturbation at float rounding level grows like exp(lambda t),
+    // so no propagator can hold `tolerance` against the reference past this time
+    result.lyapunov_exponent = estimate_lyapunov(system_, initial, config_.fine_dt, config_.t_end);
+    float scale = 0.0f;
+    for (const auto& u : U) scale = std::max(scale, glm::length(u));
+    float rounding = FLT_EPSILON * std::max(scale, 1.0f);
+    if (result.lyapunov_exponent > 0.0f) {
+        result.horizon = std::log(config_.tolerance / rounding) / result.lyapunov_exponent;
+    } else {
+        result.horizon = INFINITY;
+    }
+
+    return result;
+}
+
+float estimate_lyapunov(const LorenzSolver& system, glm::vec3 state, float dt, float duration) {
+    const float d0 = 1e-3f;        // Large enough to stay above float resolution
+    const long renorm_steps = 10;
+    long steps = std::max(1L, std::lround(duration / dt));
+
+    glm::vec3 other = state + glm::vec3(d0, 0.0f, 0.0f);
+    double log_sum = 0.0;
+    long done = 0;
+    while (done < steps) {
+        long chunk = std::min(renorm_steps, steps - done);
+        state = system.integrate(state, dt, chunk);
+        other = system.integrate(other, dt, chunk);
+        done += chunk;
+
+        glm::vec3 sep = other - state;
+        float d = glm::length(sep);
+        if (d <= 0.0f) break;
+        log_sum += std::log(d / d0);
+        other = state + sep * (d0 / d);
+    }
+    return static_cast<float>(log_sum / (done * dt));
+}
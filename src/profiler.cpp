@@ -0,0 +1,217 @@
+// profiler.cpp - Scoped timing zones and perf_event_open counters
+#include "profiler.h"
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+using Clock = std::chrono::high_resolution_clock;
+
+// One perf event group per thread: cycles leads, the rest are read with it
+struct CounterGroup {
+    static constexpr int kEvents = 4;
+    int fds[kEvents] = {-1, -1, -1, -1};
+    bool tried = false;
+    bool ok = false;
+
+    ~CounterGroup() {
+        #ifdef __linux__
+        for (int fd : fds) {
+            if (fd >= 0) close(fd);
+        }
+        #endif
+    }
+
+    bool open() {
+        if (tried) return ok;
+        tried = true;
+        #ifdef __linux__
+        const uint64_t configs[kEvents] = {
+            PERF_COUNT_HW_CPU_CYCLES,
+            PERF_COUNT_HW_INSTRUCTIONS,
+            PERF_COUNT_HW_CACHE_MISSES,
+            PERF_COUNT_HW_BRANCH_MISSES,
+        };
+        for (int i = 0; i < kEvents; ++i) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = configs[i];
+            attr.disabled = i == 0;
+            attr.exclude_kernel = 1;   // Allowed at perf_event_paranoid <= 2
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP |
+                               PERF_FORMAT_TOTAL_TIME_ENABLED |
+                               PERF_FORMAT_TOTAL_TIME_RUNNING;
+            long fd = syscall(__NR_perf_event_open, &attr, 0, -1, i == 0 ? -1 : fds[0], 0);
+            if (fd < 0) return false;
+            fds[i] = static_cast<int>(fd);
+        }
+        ioctl(fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        ok = true;
+        #endif
+        return ok;
+    }
+
+    bool read(CounterSample& out) {
+        if (!open()) return false;
+        #ifdef __linux__
+        struct {
+            uint64_t nr;
+            uint64_t time_enabled;
+            uint64_t time_running;
+            uint64_t values[kEvents];
+        } data;
+        if (::read(fds[0], &data, sizeof(data)) != static_cast<ssize_t>(sizeof(data))) return false;
+
+        out.raw.cycles = data.values[0];
+        out.raw.instructions = data.values[1];
+        out.raw.cache_misses = data.values[2];
+        out.raw.branch_misses = data.values[3];
+        out.time_enabled = data.time_enabled;
+        out.time_running = data.time_running;
+        return true;
+        #else
+        (void)out;
+        return false;
+        #endif
+    }
+};
+
+thread_local CounterGroup t_counters;
+
+void accumulate(ZoneStats& into, const ZoneStats& from) {
+    into.calls += from.calls;
+    into.items += from.items;
+    into.seconds += from.seconds;
+    into.hw.cycles += from.hw.cycles;
+    into.hw.instructions += from.hw.instructions;
+    into.hw.cache_misses += from.hw.cache_misses;
+    into.hw.branch_misses += from.hw.branch_misses;
+    into.has_hw = into.has_hw || from.has_hw;
+}
+
+} // namespace
+
+Profiler& Profiler::instance() {
+    static Profiler profiler;
+    return profiler;
+}
+
+Profiler::Profiler()
+    : publish_timer_(Clock::now())
+{
+}
+
+void Profiler::enableCounters(bool enable) {
+    counters_enabled_.store(enable, std::memory_order_relaxed);
+}
+
+bool Profiler::countersAvailable() const {
+    return t_counters.open();
+}
+
+bool Profiler::readCounters(CounterSample& out) {
+    return t_counters.read(out);
+}
+
+HwCounters Profiler::delta(const CounterSample& start, const CounterSample& end) {
+    // The kernel multiplexes when the PMU is oversubscribed. The ratio of the
+    // interval's own enabled and running times extrapolates its counts;
+    // scaling the running totals separately would not cancel.
+    uint64_t enabled = end.time_enabled - start.time_enabled;
+    uint64_t running = end.time_running - start.time_running;
+    double scale = running ? static_cast<double>(enabled) / running : 1.0;
+    auto scaled = [scale](uint64_t from, uint64_t to) {
+        return to > from ? static_cast<uint64_t>((to - from) * scale) : 0;
+    };
+    HwCounters out;
+    out.cycles = scaled(start.raw.cycles, end.raw.cycles);
+    out.instructions = scaled(start.raw.instructions, end.raw.instructions);
+    out.cache_misses = scaled(start.raw.cache_misses, end.raw.cache_misses);
+    out.branch_misses = scaled(start.raw.branch_misses, end.raw.branch_misses);
+    return out;
+}
+
+ZoneStats& Profiler::find(std::vector<ZoneStats>& zones, const char* name) {
+    for (auto& zone : zones) {
+        if (zone.name == name) return zone;
+    }
+    zones.emplace_back();
+    zones.back().name = name;
+    return zones.back();
+}
+
+void Profiler::record(const char* name, double seconds, uint64_t items, const HwCounters* hw) {
+    ZoneStats sample;
+    sample.calls = 1;
+    sample.items = items;
+    sample.seconds = seconds;
+    if (hw) {
+        sample.hw = *hw;
+        sample.has_hw = true;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    accumulate(find(current_, name), sample);
+    accumulate(find(totals_, name), sample);
+}
+
+void Profiler::endFrame() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++frames_;
+    auto now = Clock::now();
+    if (std::chrono::duration<double>(now - publish_timer_).count() < 0.25) return;
+
+    // Average over the frames since the last publish
+    published_ = current_;
+    for (auto& zone : published_) {
+        zone.calls /= frames_;
+        zone.items /= frames_;
+        zone.seconds /= frames_;
+        zone.hw.cycles /= frames_;
+        zone.hw.instructions /= frames_;
+        zone.hw.cache_misses /= frames_;
+        zone.hw.branch_misses /= frames_;
+    }
+    current_.clear();
+    frames_ = 0;
+    publish_timer_ = now;
+}
+
+std::vector<ZoneStats> Profiler::snapshot() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return published_;
+}
+
+std::vector<ZoneStats> Profiler::totals() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return totals_;
+}
+
+ProfileZone::ProfileZone(const char* name, uint64_t items)
+    : name_(name)
+    , items_(items)
+    , counting_(Profiler::instance().countersEnabled())
+{
+    if (counting_) counting_ = Profiler::readCounters(start_hw_);
+    start_ = Clock::now();
+}
+
+ProfileZone::~ProfileZone() {
+    double seconds = std::chrono::duration<double>(Clock::now() - start_).count();
+    CounterSample end_hw;
+    if (counting_ && Profiler::readCounters(end_hw)) {
+        HwCounters delta = Profiler::delta(start_hw_, end_hw);
+        Profiler::instance().record(name_, seconds, items_, &delta);
+    } else {
+        Profiler::instance().record(name_, seconds, items_, nullptr);
+    }
+}
@@ -0,0 +1,270 @@
+// result_cache.cpp - Mapped loads, atomic stores and LRU eviction
+#include "result_cache.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <system_error>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const char kMagic[4] = {'L', 'Z', 'R', 'C'};
+const uint32_t kVersion = 1;
+const char* kExtension = ".lzr";
+
+struct BlobHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t payload_bytes;
+    uint64_t key_lo;
+    uint64_t key_hi;
+};
+
+// 64-byte aligned payloads, so mapped arrays can be read in place
+constexpr size_t kPayloadOffset = 64;
+static_assert(sizeof(BlobHeader) <= kPayloadOffset, "header must fit before the payload");
+
+bool write_all(int fd, const void* data, size_t bytes) {
+    const char* p = static_cast<const char*>(data);
+    while (bytes > 0) {
+        ssize_t written = ::write(fd, p, bytes);
+        if (written < 0) return false;
+        p += written;
+        bytes -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+} // namespace
+
+CacheKey::CacheKey(const std::string& analysis)
+    : lo_(1469598103934665603ull), hi_(0x6c62272e07bb0142ull)
+{
+    add(analysis);
+}
+
+void CacheKey::mix(const void* data, size_t bytes) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < bytes; ++i) {
+        lo_ = (lo_ ^ p[i]) * 1099511628211ull;
+        hi_ = (hi_ ^ p[i] ^ 0xa5) * 1099511628211ull;
+    }
+}
+
+CacheKey& CacheKey::add(double value) {
+    mix(&value, sizeof(value));
+    return *this;
+}
+
+CacheKey& CacheKey::add(const std::string& text) {
+    // Length first, so ("ab", "c") and ("a", "bc") differ
+    uint64_t length = text.size();
+    mix(&length, sizeof(length));
+    mix(text.data(), text.size());
+    return *this;
+}
+
+std::string CacheKey::hex() const {
+    char text[33];
+    std::snprintf(text, sizeof(text), "%016llx%016llx",
+                  static_cast<unsigned long long>(hi_), static_cast<unsigned long long>(lo_));
+    return text;
+}
+
+ResultCache::Blob::~Blob() {
+    if (map_) munmap(map_, map_bytes_);
+}
+
+ResultCache::Blob::Blob(Blob&& other) noexcept
+    : map_(other.map_), map_bytes_(other.map_bytes_), payload_bytes_(other.payload_bytes_)
+{
+    other.map_ = nullptr;
+}
+
+ResultCache::Blob& ResultCache::Blob::operator=(Blob&& other) noexcept {
+    if (this != &other) {
+        if (map_) munmap(map_, map_bytes_);
+        map_ = other.map_;
+        map_bytes_ = other.map_bytes_;
+        payload_bytes_ = other.payload_bytes_;
+        other.map_ = nullptr;
+    }
+    return *this;
+}
+
+const void* ResultCache::Blob::data() const {
+    return map_ ? static_cast<const char*>(map_) + kPayloadOffset : nullptr;
+}
+
+ResultCache::ResultCache(const std::string& directory, size_t limit_bytes)
+    : directory_(directory), limit_(limit_bytes)
+{
+    std::error_code error;
+    fs::create_directories(directory_, error);
+    if (error) {
+        std::cerr << "Result cache: cannot create " << directory_ << ": " << error.message() << std::endl;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    evict("");
+}
+
+std::string ResultCache::defaultDirectory() {
+    if (const char* dir = std::getenv("LORENZ_CACHE_DIR")) return dir;
+    if (const char* xdg = std::getenv("XDG_CACHE_HOME")) return std::string(xdg) + "/lorenz_viz";
+    if (const char* home = std::getenv("HOME")) return std::string(home) + "/.cache/lorenz_viz";
+    return ".lorenz_cache";
+}
+
+std::string ResultCache::pathFor(const CacheKey& key) const {
+    return directory_ + "/" + key.hex() + kExtension;
+}
+
+ResultCache::Blob ResultCache::load(const CacheKey& key) {
+    Blob blob;
+    std::string path = pathFor(key);
+    int fd = ::open(path.c_str(), O_RDONLY);
+    struct stat info;
+    if (fd >= 0 && fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) >= kPayloadOffset) {
+        size_t file_bytes = static_cast<size_t>(info.st_size);
+        void* map = mmap(nullptr, file_bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map != MAP_FAILED) {
+            BlobHeader header;
+            std::memcpy(&header, map, sizeof(header));
+            if (std::memcmp(header.magic, kMagic, 4) == 0 && header.version == kVersion &&
+                header.key_lo == key.lo() && header.key_hi == key.hi() &&
+                header.payload_bytes == file_bytes - kPayloadOffset) {
+                blob.map_ = map;
+                blob.map_bytes_ = file_bytes;
+                blob.payload_bytes_ = header.payload_bytes;
+            } else {
+                munmap(map, file_bytes);
+                std::cerr << "Result cache: discarding malformed " << path << std::endl;
+                std::remove(path.c_str());
+            }
+        }
+    }
+    if (fd >= 0) ::close(fd);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (blob) {
+        ++hits_;
+        std::error_code error;
+        fs::last_write_time(path, fs::file_time_type::clock::now(), error);   // Most recently used
+    } else {
+        ++misses_;
+    }
+    return blob;
+}
+
+bool ResultCache::store(const CacheKey& key, const void* data, size_t bytes) {
+    if (kPayloadOffset + bytes > limit_) return false;   // Would evict everything, itself included
+
+    std::string path = pathFor(key);
+    // A unique temp name per store: two stores of one key (a frame job and a
+    // worker job, or two processes) must not write into the same file
+    std::string temp = path + ".tmpXXXXXX";
+    int fd = mkstemp(&temp[0]);
+    if (fd >= 0) fchmod(fd, 0644);
+    if (fd < 0) {
+        std::cerr << "Result cache: cannot write " << temp << std::endl;
+        return false;
+    }
+    char header_bytes[kPayloadOffset] = {};
+    BlobHeader header;
+    std::memcpy(header.magic, kMagic, 4);
+    header.version = kVersion;
+    header.payload_bytes = bytes;
+    header.key_lo = key.lo();
+    header.key_hi = key.hi();
+    std::memcpy(header_bytes, &header, sizeof(header));
+    bool ok = write_all(fd, header_bytes, kPayloadOffset) && write_all(fd, data, bytes);
+    ok = ::close(fd) == 0 && ok;
+    if (!ok || std::rename(temp.c_str(), path.c_str()) != 0) {
+        std::cerr << "Result cache: failed to store " << path << std::endl;
+        std::remove(temp.c_str());
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    evict(path);
+    return true;
+}
+
+void ResultCache::setLimit(size_t limit_bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    limit_ = limit_bytes;
+    evict("");
+}
+
+void ResultCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::error_code error;
+    for (const auto& entry : fs::directory_iterator(directory_, error)) {
+        if (entry.path().extension() == kExtension) fs::remove(entry.path(), error);
+    }
+    bytes_ = 0;
+    entries_ = 0;
+}
+
+void ResultCache::evict(const std::string& keep) {
+    struct File {
+        fs::file_time_type used;
+        size_t bytes;
+        fs::path path;
+    };
+    std::vector<File> files;
+    size_t total = 0;
+    std::error_code error;
+    for (const auto& entry : fs::directory_iterator(directory_, error)) {
+        if (entry.path().extension() != kExtension) continue;
+        std::error_code stat_error;
+        File file{entry.last_write_time(stat_error), static_cast<size_t>(entry.file_size(stat_error)), entry.path()};
+        if (stat_error) continue;   // Removed by another process meanwhile
+        total += file.bytes;
+        files.push_back(std::move(file));
+    }
+
+    // Oldest first; a blob still mapped by a reader stays valid after unlink
+    std::sort(files.begin(), files.end(), [](const File& a, const File& b) { return a.used < b.used; });
+    size_t count = files.size();
+    for (const File& file : files) {
+        if (total <= limit_) break;
+        if (file.path == keep) continue;
+        if (fs::remove(file.path, error)) {
+            total -= file.bytes;
+            --count;
+        }
+    }
+    bytes_ = total;
+    entries_ = count;
+}
+
+size_t ResultCache::bytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return bytes_;
+}
+
+size_t ResultCache::entries() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_;
+}
+
+size_t ResultCache::hits() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hits_;
+}
+
+size_t ResultCache::misses() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return misses_;
+}
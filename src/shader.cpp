@@ -4,69 +4,84 @@
 #include <sstream>
 #include <iostream>
 
-Shader::Shader(const char* vertexPath, const char* fragmentPath) {
-    // 1. Retrieve the vertex/fragment source code from filePath
-    std::string vertexCode;
-    std::string fragmentCode;
-    std::ifstream vShaderFile;
-    std::ifstream fShaderFile;
-    
-    // Ensure ifstream objects can throw exceptions
-    vShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-    fShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-    
+namespace {
+
+// Read a whole shader file; empty (with a message) if it cannot be read
+std::string read_source(const char* path) {
+    std::ifstream file;
+    file.exceptions(std::ifstream::failbit | std::ifstream::badbit);
     try {
-        // Open files
-        vShaderFile.open(vertexPath);
-        fShaderFile.open(fragmentPath);
-        std::stringstream vShaderStream, fShaderStream;
-        
-        // Read file's buffer contents into streams
-        vShaderStream << vShaderFile.rdbuf();
-        fShaderStream << fShaderFile.rdbuf();
-        
-        // Close file handlers
-        vShaderFile.close();
-        fShaderFile.close();
-        
-        // Convert stream into string
-        vertexCode = vShaderStream.str();
-        fragmentCode = fShaderStream.str();
+        file.open(path);
+        std::stringstream stream;
+        stream << file.rdbuf();
+        file.close();
+        return stream.str();
     }
     catch (std::ifstream::failure& e) {
         std::cout << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ" << std::endl;
-        std::cout << "Vertex path: " << vertexPath << std::endl;
-        std::cout << "Fragment path: " << fragmentPath << std::endl;
+        std::cout << "Path: " << path << std::endl;
     }
+    return std::string();
+}
+
+} // namespace
+
+Shader::Shader(const char* vertexPath, const char* fragmentPath, const char* geometryPath) {
+    ShaderSources sources;
+    sources.vertex = vertexPath;
+    sources.fragment = fragmentPath;
+    sources.geometry = geometryPath;
+    build(sources);
+}
+
+Shader::Shader(const ShaderSources& sources) {
+    build(sources);
+}
+
+void Shader::build(const ShaderSources& sources) {
+    // 1. Compile each stage from its file
+    const struct { GLenum type; const char* path; const char* label; } stages[] = {
+        {GL_VERTEX_SHADER, sources.vertex, "VERTEX"},
+        {GL_TESS_CONTROL_SHADER, sources.tessControl, "TESS_CONTROL"},
+        {GL_TESS_EVALUATION_SHADER, sources.tessEvaluation, "TESS_EVALUATION"},
+        {GL_GEOMETRY_SHADER, sources.geometry, "GEOMETRY"},
+        {GL_FRAGMENT_SHADER, sources.fragment, "FRAGMENT"},
+        {GL_COMPUTE_SHADER, sources.compute, "COMPUTE"},
+    };
     
-    const char* vShaderCode = vertexCode.c_str();
-    const char* fShaderCode = fragmentCode.c_str();
-    
-    // 2. Compile shaders
-    GLuint vertex, fragment;
-    
-    // Vertex shader
-    vertex = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertex, 1, &vShaderCode, NULL);
-    glCompileShader(vertex);
-    checkCompileErrors(vertex, "VERTEX");
-    
-    // Fragment shader
-    fragment = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragment, 1, &fShaderCode, NULL);
-    glCompileShader(fragment);
-    checkCompileErrors(fragment, "FRAGMENT");
-    
-    // Shader program
+    // 2. Shader program
     ID = glCreateProgram();
-    glAttachShader(ID, vertex);
-    glAttachShader(ID, fragment);
+    GLuint compiled[6];
+    int count = 0;
+    for (const auto& stage : stages) {
+        if (!stage.path) continue;
+        compiled[count] = compileStage(stage.type, stage.path, stage.label);
+        glAttachShader(ID, compiled[count++]);
+    }
     glLinkProgram(ID);
     checkCompileErrors(ID, "PROGRAM");
     
     // Delete the shaders as they're linked into our program now and no longer necessary
-    glDeleteShader(vertex);
-    glDeleteShader(fragment);
+    for (int i = 0; i < count; ++i) {
+        glDeleteShader(compiled[i]);
+    }
+}
+
+bool Shader::isLinked() const {
+    GLint success = 0;
+    glGetProgramiv(ID, GL_LINK_STATUS, &success);
+    return success != 0;
+}
+
+GLuint Shader::compileStage(GLenum type, const char* path, const std::string& label) {
+    std::string code = read_source(path);
+    const char* source = code.c_str();
+    
+    GLuint shader = glCreateShader(type);
+    glShaderSource(shader, 1, &source, NULL);
+    glCompileShader(shader);
+    checkCompileErrors(shader, label);
+    return shader;
 }
 
 void Shader::use() const {
@@ -89,6 +104,10 @@ void Shader::setMat4(const std::string &name, const float* value) const {
     glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, value);
 }
 
+void Shader::setVec2(const std::string &name, float x, float y) const {
+    glUniform2f(glGetUniformLocation(ID, name.c_str()), x, y);
+}
+
 void Shader::setVec3(const std::string &name, float x, float y, float z) const {
     glUniform3f(glGetUniformLocation(ID, name.c_str()), x, y, z);
 }
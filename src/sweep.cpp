@@ -0,0 +1,467 @@
+// sweep.cpp - Coordinator/worker protocol for distributed bifurcation sweeps
+#include "sweep.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "analysis_jobs.h"
+#include "headless.h"
+
+#ifdef __linux__
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Every message is a type and a payload length, then the payload. Workers run
+// the same binary, so settings travel as raw structs in native layout.
+enum class MessageType : uint32_t { Pull = 1, Chunk = 2, Result = 3, Stop = 4 };
+
+struct Frame {
+    uint32_t type;
+    uint32_t bytes;
+};
+
+constexpr uint32_t kMaxPayload = 64u << 20;
+
+struct ChunkRequest {
+    uint32_t chunk;
+    int32_t first;
+    int32_t count;
+    BifurcationSettings settings;
+};
+static_assert(std::is_trivially_copyable<ChunkRequest>::value, "sent as raw bytes");
+
+// Result payload: chunk id and column count, then per column the number of
+// maxima followed by their z values (rho follows from the column index)
+struct ResultHeader {
+    uint32_t chunk;
+    uint32_t columns;
+};
+
+bool send_all(int fd, const void* data, size_t bytes) {
+    const char* p = static_cast<const char*>(data);
+    while (bytes > 0) {
+        ssize_t n = send(fd, p, bytes, MSG_NOSIGNAL);
+        if (n <= 0) return false;
+        p += n;
+        bytes -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool recv_all(int fd, void* data, size_t bytes) {
+    char* p = static_cast<char*>(data);
+    while (bytes > 0) {
+        ssize_t n = recv(fd, p, bytes, 0);
+        if (n <= 0) return false;   // Closed, reset or timed out
+        p += n;
+        bytes -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool send_message(int fd, MessageType type, const void* payload = nullptr, size_t bytes = 0) {
+    Frame frame{static_cast<uint32_t>(type), static_cast<uint32_t>(bytes)};
+    return send_all(fd, &frame, sizeof(frame)) && (bytes == 0 || send_all(fd, payload, bytes));
+}
+
+bool recv_message(int fd, MessageType& type, std::vector<char>& payload) {
+    Frame frame;
+    if (!recv_all(fd, &frame, sizeof(frame)) || frame.bytes > kMaxPayload) return false;
+    type = static_cast<MessageType>(frame.type);
+    payload.resize(frame.bytes);
+    return frame.bytes == 0 || recv_all(fd, payload.data(), frame.bytes);
+}
+
+// "unix:/path" or "tcp:host:port"
+struct Address {
+    sockaddr_storage storage;
+    socklen_t length = 0;
+    std::string unix_path;
+};
+
+bool parse_address(const std::string& text, Address& address) {
+    std::memset(&address.storage, 0, sizeof(address.storage));
+    if (text.compare(0, 5, "unix:") == 0) {
+        sockaddr_un* un = reinterpret_cast<sockaddr_un*>(&address.storage);
+        address.unix_path = text.substr(5);
+        if (address.unix_path.empty() || address.unix_path.size() >= sizeof(un->sun_path)) return false;
+        un->sun_family = AF_UNIX;
+        std::strcpy(un->sun_path, address.unix_path.c_str());
+        address.length = sizeof(sockaddr_un);
+        return true;
+    }
+    if (text.compare(0, 4, "tcp:") == 0) {
+        size_t colon = text.rfind(':');
+        if (colon <= 4) return false;
+        std::string host = text.substr(4, colon - 4);
+        std::string port = text.substr(colon + 1);
+        addrinfo hints;
+        std::memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo* found = nullptr;
+        if (getaddrinfo(host.c_str(), port.c_str(), &hints, &found) != 0 || !found) return false;
+        std::memcpy(&address.storage, found->ai_addr, found->ai_addrlen);
+        address.length = found->ai_addrlen;
+        freeaddrinfo(found);
+        return true;
+    }
+    return false;
+}
+
+int open_socket(const Address& address) {
+    int fd = socket(address.storage.ss_family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd >= 0 && address.storage.ss_family == AF_INET) {
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+    return fd;
+}
+
+pid_t spawn_worker(const std::string& address, int crash_after) {
+    pid_t pid = fork();
+    if (pid < 0) {
+        std::cerr << "Sweep: cannot start a worker (" << std::strerror(errno) << ")" << std::endl;
+        return -1;
+    }
+    if (pid != 0) return pid;
+    std::string crash = std::to_string(crash_after);
+    std::vector<const char*> args = {"lorenz_viz", "--worker", "--connect", address.c_str()};
+    if (crash_after >= 0) {
+        args.push_back("--crash-after");
+        args.push_back(crash.c_str());
+    }
+    args.push_back(nullptr);
+    execv("/proc/self/exe", const_cast<char* const*>(args.data()));
+    _exit(127);
+}
+
+struct Connection {
+    int fd;
+    int chunk = -1;         // In flight, or -1
+    bool waiting = false;   // Pulled while the queue was empty
+    Clock::time_point deadline;
+};
+
+} // namespace
+
+int run_sweep(int argc, char** argv) {
+    BifurcationSettings settings;
+    settings.rho_min = arg_float(argc, argv, "--rho-min", settings.rho_min);
+    settings.rho_max = arg_float(argc, argv, "--rho-max", settings.rho_max);
+    settings.sigma = arg_float(argc, argv, "--sigma", settings.sigma);
+    settings.beta = arg_float(argc, argv, "--beta", settings.beta);
+    settings.dt = arg_float(argc, argv, "--dt", settings.dt);
+    settings.columns = std::max(1, arg_int(argc, argv, "--columns", 2048));
+    settings.transient_steps = arg_long(argc, argv, "--transient", settings.transient_steps);
+    settings.maxima_per_column = std::max(1, arg_int(argc, argv, "--maxima", settings.maxima_per_column));
+    const int chunk_columns = std::max(1, arg_int(argc, argv, "--chunk", 32));
+    const int workers = std::max(0, arg_int(argc, argv, "--workers", 4));
+    const float chunk_timeout = arg_float(argc, argv, "--chunk-timeout", 30.0f);
+    const int crash_after = arg_int(argc, argv, "--crash-after", -1);   // Passed to the first local worker
+    const std::string out_path = arg_string(argc, argv, "--out", "");
+    const std::string listen_text = arg_string(argc, argv, "--listen",
+        ("unix:/tmp/lorenz_sweep_" + std::to_string(getpid()) + ".sock").c_str());
+
+    Address address;
+    if (!parse_address(listen_text, address)) {
+        std::cerr << "Sweep: bad address " << listen_text << " (want unix:/path or tcp:host:port)" << std::endl;
+        return -1;
+    }
+    if (!address.unix_path.empty()) unlink(address.unix_path.c_str());
+    int listen_fd = open_socket(address);
+    if (listen_fd >= 0) {
+        int reuse = 1;
+        setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    }
+    if (listen_fd < 0 || bind(listen_fd, reinterpret_cast<sockaddr*>(&address.storage), address.length) != 0 ||
+        listen(listen_fd, 64) != 0) {
+        std::cerr << "Sweep: cannot listen on " << listen_text << " (" << std::strerror(errno) << ")" << std::endl;
+        if (listen_fd >= 0) close(listen_fd);
+        return -1;
+    }
+
+    const int chunks = (settings.columns + chunk_columns - 1) / chunk_columns;
+    std::deque<int> queue;
+    for (int c = 0; c < chunks; ++c) queue.push_back(c);
+    std::vector<bool> done(chunks, false);
+    std::vector<std::vector<float>> maxima(settings.columns);
+    int chunks_done = 0;
+    int reissued = 0;
+
+    // A local worker that dies is replaced, up to twice the initial count.
+    // Only started workers are recorded: pid -1 would mean every process.
+    std::vector<pid_t> children;
+    int spawns_left = workers * 2;
+    for (int i = 0; i < workers; ++i) {
+        pid_t child = spawn_worker(listen_text, i == 0 ? crash_after : -1);
+        if (child > 0) children.push_back(child);
+    }
+    int peak_workers = 0;
+
+    std::cout << "Sweep: " << settings.columns << " columns in " << chunks << " chunks on " << listen_text
+              << ", " << workers << " local workers" << std::endl;
+
+    std::vector<Connection> connections;
+    auto requeue = [&](Connection& connection) {
+        if (connection.chunk >= 0 && !done[connection.chunk]) {
+            queue.push_front(connection.chunk);
+            ++reissued;
+        }
+        connection.chunk = -1;
+    };
+    auto drop = [&](Connection& connection) {
+        requeue(connection);
+        close(connection.fd);
+        connection.fd = -1;
+    };
+    auto assign = [&](Connection& connection) {
+        // Skip chunks finished meanwhile by an earlier holder
+        while (!queue.empty() && done[queue.front()]) queue.pop_front();
+        if (queue.empty()) {
+            connection.waiting = true;
+            return;
+        }
+        ChunkRequest request{};
+        request.chunk = static_cast<uint32_t>(queue.front());
+        request.first = queue.front() * chunk_columns;
+        request.count = std::min(chunk_columns, settings.columns - request.first);
+        request.settings = settings;
+        queue.pop_front();
+        connection.chunk = static_cast<int>(request.chunk);
+        connection.waiting = false;
+        connection.deadline = Clock::now() + std::chrono::milliseconds(static_cast<long>(chunk_timeout * 1000.0f));
+        if (!send_message(connection.fd, MessageType::Chunk, &request, sizeof(request))) drop(connection);
+    };
+
+    auto start = Clock::now();
+    bool failed = false;
+    while (chunks_done < chunks) {
+        // Replace local workers that exited while work remains
+        for (pid_t& child : children) {
+            int status;
+            if (child > 0 && waitpid(child, &status, WNOHANG) == child) {
+                std::cerr << "Sweep: worker " << child << " exited" << std::endl;
+                child = spawns_left-- > 0 ? spawn_worker(listen_text, -1) : -1;
+            }
+        }
+        // With only remote workers, wait for them indefinitely
+        bool children_alive = std::any_of(children.begin(), children.end(), [](pid_t pid) { return pid > 0; });
+        if (workers > 0 && connections.empty() && !children_alive) {
+            std::cerr << "Sweep: no workers left with " << chunks - chunks_done << " chunks to go" << std::endl;
+            failed = true;
+            break;
+        }
+
+        std::vector<pollfd> fds;
+        fds.push_back({listen_fd, POLLIN, 0});
+        for (const Connection& connection : connections) fds.push_back({connection.fd, POLLIN, 0});
+        if (poll(fds.data(), fds.size(), 100) < 0 && errno != EINTR) break;
+
+        for (size_t i = 0; i + 1 < fds.size(); ++i) {
+            Connection& connection = connections[i];
+            short events = fds[i + 1].revents;
+            if (!(events & (POLLIN | POLLHUP | POLLERR))) continue;
+
+            MessageType type;
+            std::vector<char> payload;
+            if (!recv_message(connection.fd, type, payload)) {
+                drop(connection);
+                continue;
+            }
+            if (type == MessageType::Pull) {
+                assign(connection);
+            } else if (type == MessageType::Result && payload.size() >= sizeof(ResultHeader)) {
+                ResultHeader header;
+                std::memcpy(&header, payload.data(), sizeof(header));
+                int chunk = static_cast<int>(header.chunk);
+                int first = chunk * chunk_columns;
+                bool valid = chunk >= 0 && chunk < chunks &&
+                             static_cast<int>(header.columns) == std::min(chunk_columns, settings.columns - first);
+                size_t offset = sizeof(header);
+                std::vector<std::vector<float>> columns(valid ? header.columns : 0);
+                for (auto& column : columns) {
+                    uint32_t count;
+                    if (offset + sizeof(count) > payload.size()) { valid = false; break; }
+                    std::memcpy(&count, payload.data() + offset, sizeof(count));
+                    offset += sizeof(count);
+                    if (offset + count * sizeof(float) > payload.size()) { valid = false; break; }
+                    column.resize(count);
+                    std::memcpy(column.data(), payload.data() + offset, count * sizeof(float));
+                    offset += count * sizeof(float);
+                }
+                if (!valid) {
+                    std::cerr << "Sweep: malformed result, dropping worker" << std::endl;
+                    drop(connection);
+                    continue;
+                }
+                // A re-issued chunk may come back twice; the copies are identical
+                if (!done[chunk]) {
+                    for (size_t c = 0; c < columns.size(); ++c) maxima[first + c] = std::move(columns[c]);
+                    done[chunk] = true;
+                    ++chunks_done;
+                }
+                if (connection.chunk == chunk) connection.chunk = -1;
+            } else {
+                drop(connection);
+            }
+        }
+
+        // After the reads, so connections still lines up with fds
+        if (fds[0].revents & POLLIN) {
+            int fd = accept4(listen_fd, nullptr, nullptr, SOCK_CLOEXEC);
+            if (fd >= 0) {
+                // A stalled sender must not hang the coordinator inside one message
+                timeval timeout{5, 0};
+                setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+                Connection connection;
+                connection.fd = fd;
+                connections.push_back(connection);
+                peak_workers = std::max(peak_workers, static_cast<int>(connections.size()));
+            }
+        }
+
+        // Late chunks go back to the queue; their worker is presumed stuck
+        auto now = Clock::now();
+        for (Connection& connection : connections) {
+            if (connection.fd >= 0 && connection.chunk >= 0 && now > connection.deadline) {
+                std::cerr << "Sweep: chunk " << connection.chunk << " timed out" << std::endl;
+                drop(connection);
+            }
+        }
+        connections.erase(std::remove_if(connections.begin(), connections.end(),
+                                         [](const Connection& c) { return c.fd < 0; }), connections.end());
+        for (Connection& connection : connections) {
+            if (connection.waiting) assign(connection);
+        }
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    for (Connection& connection : connections) {
+        send_message(connection.fd, MessageType::Stop);
+        close(connection.fd);
+    }
+    close(listen_fd);
+    if (!address.unix_path.empty()) unlink(address.unix_path.c_str());
+    for (pid_t child : children) {
+        if (child > 0) waitpid(child, nullptr, 0);
+    }
+    if (failed) return 1;
+
+    size_t points = 0;
+    for (const auto& column : maxima) points += column.size();
+    if (!out_path.empty()) {
+        std::ofstream out(out_path);
+        out << "rho,z\n";
+        for (int c = 0; c < settings.columns; ++c) {
+            for (float z : maxima[c]) out << bifurcationRho(settings, c) << "," << z << "\n";
+        }
+        if (!out) {
+            std::cerr << "Sweep: failed to write " << out_path << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "\n=== Distributed Sweep ===" << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Columns:   " << settings.columns << " (rho " << settings.rho_min << ".." << settings.rho_max
+              << "), " << chunks << " chunks of " << chunk_columns << std::endl;
+    std::cout << "Workers:   " << peak_workers << " connected at peak" << std::endl;
+    std::cout << "Reissued:  " << reissued << " chunks" << std::endl;
+    std::cout << "Maxima:    " << points << std::endl;
+    std::cout << "Time:      " << seconds << " s (" << settings.columns / seconds << " columns/s)" << std::endl;
+    if (!out_path.empty()) std::cout << "Output:    " << out_path << std::endl;
+    std::cout << "=========================\n" << std::endl;
+    return 0;
+}
+
+int run_sweep_worker(int argc, char** argv) {
+    const std::string connect_text = arg_string(argc, argv, "--connect", "");
+    const int crash_after = arg_int(argc, argv, "--crash-after", -1);
+    Address address;
+    if (!parse_address(connect_text, address)) {
+        std::cerr << "Worker: bad or missing --connect address '" << connect_text << "'" << std::endl;
+        return -1;
+    }
+
+    // The coordinator may still be starting: retry for a while
+    int fd = -1;
+    for (int attempt = 0; attempt < 100; ++attempt) {
+        fd = open_socket(address);
+        if (fd >= 0 && connect(fd, reinterpret_cast<sockaddr*>(&address.storage), address.length) == 0) break;
+        if (fd >= 0) close(fd);
+        fd = -1;
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    if (fd < 0) {
+        std::cerr << "Worker: cannot connect to " << connect_text << std::endl;
+        return 1;
+    }
+
+    int chunks = 0;
+    std::vector<char> payload;
+    std::vector<std::vector<float>> maxima;
+    for (;;) {
+        MessageType type;
+        if (!send_message(fd, MessageType::Pull) || !recv_message(fd, type, payload)) break;
+        if (type != MessageType::Chunk || payload.size() != sizeof(ChunkRequest)) break;   // Stop, or nonsense
+        if (chunks++ == crash_after) _exit(3);   // Simulated crash with a chunk in flight
+
+        ChunkRequest request;
+        std::memcpy(&request, payload.data(), sizeof(request));
+        bifurcationChunk(request.settings, request.first, request.count, maxima);
+
+        ResultHeader header{request.chunk, static_cast<uint32_t>(maxima.size())};
+        std::vector<char> result(reinterpret_cast<const char*>(&header),
+                                 reinterpret_cast<const char*>(&header) + sizeof(header));
+        for (const auto& column : maxima) {
+            uint32_t count = static_cast<uint32_t>(column.size());
+            const char* bytes = reinterpret_cast<const char*>(&count);
+            result.insert(result.end(), bytes, bytes + sizeof(count));
+            bytes = reinterpret_cast<const char*>(column.data());
+            result.insert(result.end(), bytes, bytes + column.size() * sizeof(float));
+        }
+        if (!send_message(fd, MessageType::Result, result.data(), result.size())) break;
+    }
+    close(fd);
+    return 0;
+}
+
+#else
+
+int run_sweep(int, char**) {
+    std::cerr << "Distributed sweeps are only available on Linux" << std::endl;
+    return -1;
+}
+
+int run_sweep_worker(int, char**) {
+    std::cerr << "Distributed sweeps are only available on Linux" << std::endl;
+    return -1;
+}
+
+#endif
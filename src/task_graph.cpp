@@ -0,0 +1,130 @@
+// task_graph.cpp - Dependency-driven task execution and critical-path tracking
+#include "task_graph.h"
+#include <algorithm>
+
+#include "profiler.h"
+
+namespace {
+
+using Clock = std::chrono::high_resolution_clock;
+
+} // namespace
+
+TaskGraph::TaskGraph(WorkerPool& pool)
+    : pool_(pool)
+{
+}
+
+TaskGraph::TaskId TaskGraph::add(const char* name, std::function<void()> fn,
+                                 std::initializer_list<TaskId> dependencies, Affinity affinity) {
+    TaskId id = static_cast<TaskId>(tasks_.size());
+    Task task;
+    task.name = name;
+    task.fn = std::move(fn);
+    task.affinity = affinity;
+    for (TaskId dependency : dependencies) {
+        // Dependencies are added first, so ids are already in topological order
+        if (dependency < 0 || dependency >= id) continue;
+        task.dependencies.push_back(dependency);
+        tasks_[dependency].dependents.push_back(id);
+    }
+    tasks_.push_back(std::move(task));
+    return id;
+}
+
+void TaskGraph::run() {
+    auto start = Clock::now();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        remaining_ = tasks_.size();
+        for (TaskId id = 0; id < static_cast<TaskId>(tasks_.size()); ++id) {
+            Task& task = tasks_[id];
+            task.pending = static_cast<int>(task.dependencies.size());
+            if (task.pending == 0) {
+                (task.affinity == Affinity::Main ? ready_main_ : ready_any_).push_back(id);
+            }
+        }
+    }
+
+    std::function<void(int, int)> worker = [this](int, int) { drain(false); };
+    pool_.start(worker);
+    drain(true);
+    pool_.wait();
+
+    wall_ms_ = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    updateCriticalPath();
+    Profiler::instance().record("critical path", critical_ms_ / 1000.0, 0, nullptr);
+}
+
+void TaskGraph::drain(bool main) {
+    for (;;) {
+        TaskId id;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            ready_.wait(lock, [&]() {
+                return remaining_ == 0 || !ready_any_.empty() || (main && !ready_main_.empty());
+            });
+            if (main && !ready_main_.empty()) {
+                id = ready_main_.front();
+                ready_main_.pop_front();
+            } else if (!ready_any_.empty()) {
+                id = ready_any_.front();
+                ready_any_.pop_front();
+            } else {
+                return;   // Everything has finished
+            }
+        }
+        execute(id);
+    }
+}
+
+void TaskGraph::execute(TaskId id) {
+    Task& task = tasks_[id];
+    auto start = Clock::now();
+    task.fn();
+    task.duration_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (TaskId dependent : task.dependents) {
+        Task& next = tasks_[dependent];
+        if (--next.pending == 0) {
+            (next.affinity == Affinity::Main ? ready_main_ : ready_any_).push_back(dependent);
+        }
+    }
+    --remaining_;
+    ready_.notify_all();
+}
+
+void TaskGraph::updateCriticalPath() {
+    // Longest duration-weighted chain, in id (= topological) order
+    std::vector<double> finish(tasks_.size(), 0.0);
+    std::vector<TaskId> parent(tasks_.size(), -1);
+    TaskId last = -1;
+    for (TaskId id = 0; id < static_cast<TaskId>(tasks_.size()); ++id) {
+        const Task& task = tasks_[id];
+        for (TaskId dependency : task.dependencies) {
+            if (finish[dependency] > finish[id]) {
+                finish[id] = finish[dependency];
+                parent[id] = dependency;
+            }
+        }
+        finish[id] += task.duration_ms;
+        if (last < 0 || finish[id] > finish[last]) last = id;
+    }
+
+    critical_path_.clear();
+    for (TaskId id = last; id >= 0; id = parent[id]) {
+        critical_path_.push_back(id);
+    }
+    std::reverse(critical_path_.begin(), critical_path_.end());
+    critical_ms_ = last >= 0 ? finish[last] : 0.0;
+}
+
+std::string TaskGraph::criticalPathNames() const {
+    std::string names;
+    for (TaskId id : critical_path_) {
+        if (!names.empty()) names += " > ";
+        names += tasks_[id].name;
+    }
+    return names;
+}
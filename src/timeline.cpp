@@ -0,0 +1,141 @@
+// timeline.cpp - Checkpoint recording, parallel chunk replay and the LRU cache
+#include "timeline.h"
+#include <algorithm>
+#include <chrono>
+
+#include "lorenz_solver.h"
+
+Timeline::Timeline(WorkerPool& pool, uint64_t interval, size_t cache_bytes)
+    : interval_(std::max<uint64_t>(interval, 1))
+    , cache_limit_(cache_bytes)
+    , pool_(pool)
+{
+}
+
+void Timeline::record(const glm::vec3& state, const LorenzParams& params, float dt) {
+    bool changed = checkpoints_.empty();
+    if (!changed) {
+        const TimelineCheckpoint& last = checkpoints_.back();
+        changed = last.dt != dt || last.params.sigma != params.sigma ||
+                  last.params.rho != params.rho || last.params.beta != params.beta;
+    }
+    if (changed || steps_ % interval_ == 0) {
+        checkpoints_.push_back({steps_, state, params, dt});
+    }
+    ++steps_;
+}
+
+void Timeline::clear() {
+    checkpoints_.clear();
+    lru_.clear();
+    cache_.clear();
+    cache_bytes_ = 0;
+    steps_ = 0;
+}
+
+size_t Timeline::chunkBytes(const Chunk& chunk) {
+    // Plus the list and hash nodes, which dominate for chunks of a few points
+    return (chunk.points.capacity() + chunk.tangents.capacity()) * sizeof(glm::vec3) + 128;
+}
+
+uint64_t Timeline::chunkEnd(size_t index) const {
+    return index + 1 < checkpoints_.size() ? checkpoints_[index + 1].step : steps_;
+}
+
+void Timeline::replay(size_t index, uint64_t stride, Chunk& out) const {
+    const TimelineCheckpoint& cp = checkpoints_[index];
+    LorenzSolver solver(cp.params.sigma, cp.params.rho, cp.params.beta);
+    uint64_t end = chunkEnd(index);
+    out.points.reserve((end - cp.step) / stride + 1);
+    out.tangents.reserve((end - cp.step) / stride + 1);
+
+    // Same arithmetic as LorenzSolver::step, so the replay is exact
+    glm::vec3 state = cp.state;
+    for (uint64_t s = cp.step; s < end; ++s) {
+        glm::vec3 k1 = solver.derivatives(state);
+        if (s % stride == 0) {
+            out.points.push_back(state);
+            out.tangents.push_back(k1 * cp.dt);
+        }
+        state = solver.rk4Step(state, k1, cp.dt);
+    }
+}
+
+const Timeline::Chunk* Timeline::cached(const Key& key) {
+    auto found = cache_.find(key);
+    if (found == cache_.end()) return nullptr;
+    lru_.splice(lru_.begin(), lru_, found->second);
+    return &found->second->second;
+}
+
+void Timeline::insert(const Key& key, Chunk&& chunk) {
+    if (cache_.count(key)) return;
+    cache_bytes_ += chunkBytes(chunk);
+    lru_.emplace_front(key, std::move(chunk));
+    cache_[key] = lru_.begin();
+    while (cache_bytes_ > cache_limit_ && lru_.size() > 1) {
+        cache_bytes_ -= chunkBytes(lru_.back().second);
+        cache_.erase(lru_.back().first);
+        lru_.pop_back();
+    }
+}
+
+void Timeline::window(uint64_t first, uint64_t last, uint64_t stride, Points& points, Points& tangents) {
+    auto start = std::chrono::high_resolution_clock::now();
+    points.clear();
+    tangents.clear();
+    stride = std::max<uint64_t>(stride, 1);
+    last = std::min(last, steps_);
+    last_hits_ = last_misses_ = 0;
+    if (checkpoints_.empty() || first >= last) return;
+
+    // Chunks [begin, end) cover the requested steps
+    auto by_step = [](const TimelineCheckpoint& cp, uint64_t step) { return cp.step < step; };
+    size_t end = std::lower_bound(checkpoints_.begin(), checkpoints_.end(), last, by_step) - checkpoints_.begin();
+    size_t begin = std::lower_bound(checkpoints_.begin(), checkpoints_.end(), first + 1, by_step) -
+                   checkpoints_.begin() - 1;
+
+    // Cached pointers stay valid until the fresh chunks are inserted below
+    std::vector<const Chunk*> chunks(end - begin, nullptr);
+    std::vector<size_t> missing;
+    for (size_t i = begin; i < end; ++i) {
+        chunks[i - begin] = cached(Key(i, stride));
+        if (!chunks[i - begin]) missing.push_back(i);
+    }
+    last_hits_ = chunks.size() - missing.size();
+    last_misses_ = missing.size();
+
+    // Every chunk starts from its own checkpoint, so they replay independently
+    std::vector<Chunk> fresh(missing.size());
+    if (!missing.empty()) {
+        pool_.run([&](int worker, int workers) {
+            for (size_t m = worker; m < missing.size(); m += workers) {
+                replay(missing[m], stride, fresh[m]);
+            }
+        });
+        for (size_t m = 0; m < missing.size(); ++m) {
+            chunks[missing[m] - begin] = &fresh[m];
+        }
+    }
+
+    // Keep the samples inside [first, last)
+    for (size_t i = begin; i < end; ++i) {
+        const Chunk& chunk = *chunks[i - begin];
+        uint64_t step = (checkpoints_[i].step + stride - 1) / stride * stride;
+        for (size_t j = 0; j < chunk.points.size(); ++j, step += stride) {
+            if (step < first) continue;
+            if (step >= last) break;
+            points.push_back(chunk.points[j]);
+            tangents.push_back(chunk.tangents[j]);
+        }
+    }
+
+    // The open chunk at the live end still grows; only closed ones are cached
+    for (size_t m = 0; m < missing.size(); ++m) {
+        if (missing[m] + 1 < checkpoints_.size()) {
+            insert(Key(missing[m], stride), std::move(fresh[m]));
+        }
+    }
+    last_replay_ms_ = std::chrono::duration<double, std::milli>(
+        std::chrono::high_resolution_clock::now() - start).count();
+}
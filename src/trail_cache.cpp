@@ -0,0 +1,214 @@
+// trail_cache.cpp - Incremental trajectory rendering implementation
+#include "trail_cache.h"
+#include <algorithm>
+
+#include "memory_tracker.h"
+
+TrailCache::TrailCache(int samples)
+    : target_({GL_RGBA8}, true, samples)
+    , oit_target_({GL_RGBA16F, GL_R8}, false)
+    , composite_("shaders/oit_composite.frag")
+{
+    glGenVertexArrays(1, &vao_);
+    glGenVertexArrays(1, &instanced_vao_);
+    glGenBuffers(1, &vbo_);
+    glGenBuffers(1, &tangent_vbo_);
+
+    // Per vertex: position (0) and tangent (1)
+    glBindVertexArray(vao_);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, tangent_vbo_);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(1);
+
+    // Per instance (= segment): both ends, read from the same buffers one
+    // element apart
+    glBindVertexArray(instanced_vao_);
+    for (GLuint end = 0; end < 2; ++end) {
+        const void* offset = reinterpret_cast<const void*>(end * sizeof(glm::vec3));
+        glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+        glVertexAttribPointer(2 * end, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), offset);
+        glBindBuffer(GL_ARRAY_BUFFER, tangent_vbo_);
+        glVertexAttribPointer(2 * end + 1, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), offset);
+        for (GLuint attrib = 2 * end; attrib < 2 * end + 2; ++attrib) {
+            glEnableVertexAttribArray(attrib);
+            glVertexAttribDivisor(attrib, 1);
+        }
+    }
+    glBindVertexArray(0);
+}
+
+TrailCache::~TrailCache() {
+    memory::sub(MemTag::GpuBuffers, 2 * capacity_ * sizeof(glm::vec3));
+    glDeleteVertexArrays(1, &vao_);
+    glDeleteVertexArrays(1, &instanced_vao_);
+    glDeleteBuffers(1, &vbo_);
+    glDeleteBuffers(1, &tangent_vbo_);
+}
+
+void TrailCache::setSamples(int samples) {
+    if (samples == target_.samples()) return;
+    target_.setSamples(samples);
+    drawn_valid_ = false;
+}
+
+void TrailCache::setOrderIndependent(bool oit) {
+    if (oit == oit_) return;
+    oit_ = oit;
+    drawn_valid_ = false;
+}
+
+void TrailCache::setPrimitive(TrailPrimitive primitive) {
+    if (primitive == primitive_) return;
+    primitive_ = primitive;
+    drawn_valid_ = false;
+}
+
+void TrailCache::upload(const glm::vec3* points, const glm::vec3* tangents, size_t count,
+                        unsigned long history_epoch) {
+    const glm::vec3* arrays[2] = {points, tangents};
+    GLuint buffers[2] = {vbo_, tangent_vbo_};
+
+    if (upload_valid_ && history_epoch == upload_epoch_ && count >= uploaded_ && count <= capacity_) {
+        // Same epoch: only the tail is new
+        if (count > uploaded_) {
+            for (int i = 0; i < 2; ++i) {
+                if (!arrays[i]) continue;
+                glBindBuffer(GL_ARRAY_BUFFER, buffers[i]);
+                glBufferSubData(GL_ARRAY_BUFFER, uploaded_ * sizeof(glm::vec3),
+                                (count - uploaded_) * sizeof(glm::vec3), arrays[i] + uploaded_);
+            }
+        }
+    } else {
+        // Indices shifted or the buffer is full: re-upload with headroom
+        size_t capacity = std::max<size_t>(count + count / 2, 4096);
+        for (int i = 0; i < 2; ++i) {
+            glBindBuffer(GL_ARRAY_BUFFER, buffers[i]);
+            if (capacity != capacity_) {
+                glBufferData(GL_ARRAY_BUFFER, capacity * sizeof(glm::vec3), nullptr, GL_DYNAMIC_DRAW);
+            }
+            if (arrays[i]) glBufferSubData(GL_ARRAY_BUFFER, 0, count * sizeof(glm::vec3), arrays[i]);
+        }
+        memory::replace(MemTag::GpuBuffers, 2 * capacity_ * sizeof(glm::vec3), 2 * capacity * sizeof(glm::vec3));
+        capacity_ = capacity;
+        upload_epoch_ = history_epoch;
+        upload_valid_ = true;
+    }
+    uploaded_ = count;
+}
+
+void TrailCache::drawRange(const RangeDrawer& draw_range, size_t first, size_t count) {
+    if (count < 2) return;
+    if (oit_) {
+        // accum += (rgb*a, a)*w; revealage *= 1 - a. No depth test: every
+        // fragment contributes, in any order
+        glDisable(GL_DEPTH_TEST);
+        glBlendFunci(0, GL_ONE, GL_ONE);
+        glBlendFunci(1, GL_ZERO, GL_ONE_MINUS_SRC_COLOR);
+    }
+    draw_range(first, count);
+    if (oit_) {
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        glEnable(GL_DEPTH_TEST);
+    }
+    segments_drawn_ += count - 1;
+}
+
+void TrailCache::drawPrimitive(size_t first, size_t count) {
+    GLsizei segments = static_cast<GLsizei>(count - 1);
+    switch (primitive_) {
+        case TrailPrimitive::Lines:
+            glBindVertexArray(vao_);
+            glDrawArrays(GL_LINE_STRIP, static_cast<GLint>(first), static_cast<GLsizei>(count));
+            break;
+        case TrailPrimitive::TessellatedSpline:
+            // Patches do not share vertices, so even and odd segments go in
+            // two draws offset by one point
+            glBindVertexArray(vao_);
+            glPatchParameteri(GL_PATCH_VERTICES, 2);
+            glDrawArrays(GL_PATCHES, static_cast<GLint>(first), 2 * ((segments + 1) / 2));
+            glDrawArrays(GL_PATCHES, static_cast<GLint>(first + 1), 2 * (segments / 2));
+            break;
+        case TrailPrimitive::InstancedSpline:
+            glBindVertexArray(instanced_vao_);
+            glDrawArraysInstancedBaseInstance(GL_LINE_STRIP, 0, subdivisions + 1, segments,
+                                              static_cast<GLuint>(first));
+            break;
+    }
+    glBindVertexArray(0);
+}
+
+void TrailCache::clearTarget() {
+    if (oit_) {
+        const GLfloat zero[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+        const GLfloat one[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+        glClearBufferfv(GL_COLOR, 0, zero);
+        glClearBufferfv(GL_COLOR, 1, one);
+    } else {
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    }
+}
+
+void TrailCache::draw(const glm::vec3* points, const glm::vec3* tangents, size_t count,
+                      unsigned long history_epoch, uint64_t view_signature,
+                      int width, int height, GLuint destination) {
+    if (!tangents) primitive_ = TrailPrimitive::Lines;
+    upload(points, tangents, count, history_epoch);
+    render([this](size_t first, size_t n) { drawPrimitive(first, n); },
+           count, history_epoch, view_signature, width, height, destination);
+}
+
+void TrailCache::render(const RangeDrawer& draw_range, size_t count, unsigned long history_epoch,
+                        uint64_t view_signature, int width, int height, GLuint destination) {
+    segments_drawn_ = 0;
+    rebuilt_ = false;
+
+    // Uncached and single-sample: nothing to keep or resolve, draw in place.
+    // With MSAA the trail still goes through the multisampled target.
+    if (!enabled && !oit_ && target_.samples() == 0) {
+        glBindFramebuffer(GL_FRAMEBUFFER, destination);
+        glViewport(0, 0, width, height);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        drawRange(draw_range, 0, count);
+        drawn_valid_ = false;
+        return;
+    }
+
+    Framebuffer& target = oit_ ? oit_target_ : target_;
+    bool resized = target.resize(width, height);
+    if (!target.valid()) return;
+    target.bind();
+
+    if (!enabled || resized || !drawn_valid_ || history_epoch != drawn_epoch_ ||
+        view_signature != drawn_view_ || count < drawn_) {
+        clearTarget();
+        drawRange(draw_range, 0, count);
+        rebuilt_ = true;
+    } else if (count > drawn_) {
+        // Restart the strip at the last cached point so the join is continuous
+        size_t first = drawn_ > 0 ? drawn_ - 1 : 0;
+        drawRange(draw_range, first, count - first);
+    }
+    drawn_ = count;
+    drawn_epoch_ = history_epoch;
+    drawn_view_ = view_signature;
+    drawn_valid_ = enabled;
+
+    if (oit_) {
+        // Average colour, weighted by coverage, blended over the background
+        glBindFramebuffer(GL_FRAMEBUFFER, destination);
+        glViewport(0, 0, width, height);
+        glClear(GL_COLOR_BUFFER_BIT);
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, oit_target_.colorTexture(1));
+        composite_.use().setInt("revealage", 1);
+        composite_.drawTexture(oit_target_.colorTexture(0), "accum");
+        return;
+    }
+
+    // Colour only: the default depth buffer format need not match ours, and
+    // nothing drawn after the trail depth-tests against it
+    target_.blitTo(destination, width, height);
+}
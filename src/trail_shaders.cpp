@@ -0,0 +1,40 @@
+// trail_shaders.cpp - Trail line program construction
+#include "trail_shaders.h"
+
+namespace {
+
+ShaderSources sources(const char* vertex, bool analytic_aa,
+                      const char* tess_control = nullptr, const char* tess_evaluation = nullptr) {
+    ShaderSources s;
+    s.vertex = vertex;
+    s.tessControl = tess_control;
+    s.tessEvaluation = tess_evaluation;
+    s.geometry = analytic_aa ? "shaders/line_aa.geom" : nullptr;
+    s.fragment = analytic_aa ? "shaders/line_aa.frag" : "shaders/basic.frag";
+    return s;
+}
+
+} // namespace
+
+TrailShaders::TrailShaders()
+    : lines_(sources("shaders/basic.vert", false))
+    , lines_aa_(sources("shaders/basic.vert", true))
+    , tessellated_(sources("shaders/spline.vert", false, "shaders/spline.tesc", "shaders/spline.tese"))
+    , tessellated_aa_(sources("shaders/spline.vert", true, "shaders/spline.tesc", "shaders/spline.tese"))
+    , instanced_(sources("shaders/spline_instanced.vert", false))
+    , instanced_aa_(sources("shaders/spline_instanced.vert", true))
+{
+    tessellation_ok_ = tessellated_.isLinked() && tessellated_aa_.isLinked();
+}
+
+const Shader& TrailShaders::get(TrailPrimitive primitive, bool analytic_aa) const {
+    switch (effective(primitive)) {
+        case TrailPrimitive::TessellatedSpline:
+            return analytic_aa ? tessellated_aa_ : tessellated_;
+        case TrailPrimitive::InstancedSpline:
+            return analytic_aa ? instanced_aa_ : instanced_;
+        case TrailPrimitive::Lines:
+            break;
+    }
+    return analytic_aa ? lines_aa_ : lines_;
+}
@@ -0,0 +1,326 @@
+// trajectory_writer.cpp - io_uring and pwrite-pool backends for TrajectoryWriter
+#include "trajectory_writer.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+#include "memory_tracker.h"
+#include "numa_memory.h"
+#include "worker_pool.h"
+
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+// Raw io_uring: no liburing dependency, just the two syscalls and the shared
+// rings. At most two writes (one per staging buffer) are ever in flight.
+struct TrajectoryWriter::Ring {
+    #if defined(__linux__) && defined(__NR_io_uring_setup)
+    int fd = -1;
+    void* sq_map = nullptr;
+    size_t sq_bytes = 0;
+    void* cq_map = nullptr;
+    size_t cq_bytes = 0;
+    io_uring_sqe* sqes = nullptr;
+    size_t sqe_bytes = 0;
+    unsigned* sq_tail = nullptr;
+    unsigned* sq_mask = nullptr;
+    unsigned* sq_array = nullptr;
+    unsigned* cq_head = nullptr;
+    unsigned* cq_tail = nullptr;
+    unsigned* cq_mask = nullptr;
+    io_uring_cqe* cqes = nullptr;
+    iovec iov[2];
+
+    bool init(unsigned entries) {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+        if (fd < 0) return false;   // ENOSYS, or blocked by a seccomp policy
+
+        sq_bytes = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_bytes = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (single) sq_bytes = cq_bytes = std::max(sq_bytes, cq_bytes);
+
+        sq_map = mmap(nullptr, sq_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+        if (sq_map == MAP_FAILED) { sq_map = nullptr; return false; }
+        if (single) {
+            cq_map = sq_map;
+        } else {
+            cq_map = mmap(nullptr, cq_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+            if (cq_map == MAP_FAILED) { cq_map = nullptr; return false; }
+        }
+        sqe_bytes = params.sq_entries * sizeof(io_uring_sqe);
+        void* sqe_map = mmap(nullptr, sqe_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+        if (sqe_map == MAP_FAILED) return false;
+        sqes = static_cast<io_uring_sqe*>(sqe_map);
+
+        char* sq = static_cast<char*>(sq_map);
+        char* cq = static_cast<char*>(cq_map);
+        sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sq_mask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cq_mask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        return true;
+    }
+
+    ~Ring() {
+        if (sqes) munmap(sqes, sqe_bytes);
+        if (cq_map && cq_map != sq_map) munmap(cq_map, cq_bytes);
+        if (sq_map) munmap(sq_map, sq_bytes);
+        if (fd >= 0) ::close(fd);
+    }
+
+    // Queue one writev and hand it to the kernel; the buffer index is the tag
+    bool submit(int file, int buffer, void* data, size_t bytes, uint64_t offset) {
+        iov[buffer].iov_base = data;
+        iov[buffer].iov_len = bytes;
+        unsigned tail = *sq_tail;   // Only this thread writes the tail
+        unsigned index = tail & *sq_mask;
+        io_uring_sqe& sqe = sqes[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = IORING_OP_WRITEV;     // Available since the first io_uring kernels (5.1)
+        sqe.fd = file;
+        sqe.addr = reinterpret_cast<uint64_t>(&iov[buffer]);
+        sqe.len = 1;
+        sqe.off = offset;
+        sqe.user_data = static_cast<uint64_t>(buffer);
+        sq_array[index] = index;
+        __atomic_store_n(sq_tail, tail + 1, __ATOMIC_RELEASE);
+        return syscall(__NR_io_uring_enter, fd, 1, 0, 0, nullptr, 0) == 1;
+    }
+
+    // Block until a completion is available and pop it
+    bool next(int& buffer, int& result) {
+        for (;;) {
+            unsigned head = *cq_head;
+            if (head != __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE)) {
+                const io_uring_cqe& cqe = cqes[head & *cq_mask];
+                buffer = static_cast<int>(cqe.user_data);
+                result = cqe.res;
+                __atomic_store_n(cq_head, head + 1, __ATOMIC_RELEASE);
+                return true;
+            }
+            if (syscall(__NR_io_uring_enter, fd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0) < 0 && errno != EINTR) {
+                return false;
+            }
+        }
+    }
+    #else
+    bool init(unsigned) { return false; }
+    bool submit(int, int, void*, size_t, uint64_t) { return false; }
+    bool next(int&, int&) { return false; }
+    #endif
+};
+
+namespace {
+
+// Blocking positional write of the whole range; returns 0 or an errno value
+int pwrite_all(int fd, const char* data, size_t bytes, uint64_t offset) {
+    while (bytes > 0) {
+        ssize_t n = pwrite(fd, data, bytes, static_cast<off_t>(offset));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return n < 0 ? errno : EIO;
+        data += n;
+        bytes -= static_cast<size_t>(n);
+        offset += static_cast<uint64_t>(n);
+    }
+    return 0;
+}
+
+} // namespace
+
+TrajectoryWriter::TrajectoryWriter(const std::string& path, size_t buffer_bytes, bool allow_uring, bool direct)
+    : buffer_bytes_((std::max(buffer_bytes, kAlignment) + kAlignment - 1) / kAlignment * kAlignment)
+{
+    int flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+    #ifdef O_DIRECT
+    if (direct) {
+        fd_ = ::open(path.c_str(), flags | O_DIRECT, 0644);
+        direct_ = fd_ >= 0;     // tmpfs and some network filesystems refuse it
+    }
+    #endif
+    if (fd_ < 0) fd_ = ::open(path.c_str(), flags, 0644);
+    if (fd_ < 0) {
+        std::cerr << "Trajectory writer: cannot open " << path << " (" << std::strerror(errno) << ")" << std::endl;
+        return;
+    }
+
+    // Page-aligned, which satisfies O_DIRECT's buffer alignment
+    for (char*& buffer : buffers_) buffer = static_cast<char*>(huge_alloc(buffer_bytes_, false));
+    if (!buffers_[0] || !buffers_[1]) {
+        std::cerr << "Trajectory writer: cannot allocate " << 2 * buffer_bytes_ << " bytes of staging" << std::endl;
+        for (char*& buffer : buffers_) {
+            if (buffer) huge_free(buffer, buffer_bytes_);
+            buffer = nullptr;
+        }
+        ::close(fd_);
+        fd_ = -1;
+        failed_ = true;
+        return;
+    }
+    memory::add(MemTag::OutputStaging, 2 * buffer_bytes_);
+
+    if (allow_uring) {
+        ring_.reset(new Ring());
+        if (ring_->init(4)) {
+            backend_ = Backend::IoUring;
+        } else {
+            ring_.reset();
+        }
+    }
+    if (backend_ == Backend::ThreadPool) pool_.reset(new WorkerPool(4, false));
+    start_ = end_ = Clock::now();
+}
+
+TrajectoryWriter::~TrajectoryWriter() {
+    close();
+    for (char* buffer : buffers_) {
+        if (buffer) huge_free(buffer, buffer_bytes_);
+    }
+    if (buffers_[0]) memory::sub(MemTag::OutputStaging, 2 * buffer_bytes_);
+}
+
+void TrajectoryWriter::append(const glm::vec3* states, size_t count) {
+    if (fd_ < 0 || closed_) return;
+    if (bytes_ == 0) start_ = Clock::now();
+    const char* data = reinterpret_cast<const char*>(states);
+    size_t bytes = count * sizeof(glm::vec3);
+    bytes_ += bytes;
+    while (bytes > 0) {
+        size_t n = std::min(bytes, buffer_bytes_ - fill_);
+        std::memcpy(buffers_[current_] + fill_, data, n);
+        fill_ += n;
+        data += n;
+        bytes -= n;
+        if (fill_ == buffer_bytes_) {
+            submit(current_, fill_);
+            current_ ^= 1;
+            fill_ = 0;
+            waitFor(current_);      // Usually long done: a stall means the disk is the bottleneck
+        }
+    }
+}
+
+void TrajectoryWriter::submit(int buffer, size_t bytes) {
+    submitted_bytes_[buffer] = bytes;
+    submitted_offset_[buffer] = file_offset_;
+    submitted_direct_[buffer] = direct_;
+    file_offset_ += bytes;
+    in_flight_[buffer] = true;
+
+    if (backend_ == Backend::IoUring) {
+        if (!ring_->submit(fd_, buffer, buffers_[buffer], bytes, submitted_offset_[buffer])) {
+            completed(buffer, errno ? errno : EIO);
+        }
+        return;
+    }
+
+    // The pool runs one job at a time, so the other buffer's stripes finish first
+    waitFor(buffer ^ 1);
+    const char* data = buffers_[buffer];
+    uint64_t offset = submitted_offset_[buffer];
+    int fd = fd_;
+    pool_error_ = 0;
+    pool_job_ = [this, data, bytes, offset, fd](int worker, int workers) {
+        size_t begin, end;
+        WorkerPool::partition(bytes, worker, workers, kAlignment, begin, end);
+        int error = pwrite_all(fd, data + begin, end - begin, offset + begin);
+        if (error) pool_error_ = error;
+    };
+    pool_->start(pool_job_);
+}
+
+void TrajectoryWriter::waitFor(int buffer) {
+    if (!in_flight_[buffer]) return;
+    auto start = Clock::now();
+    if (backend_ == Backend::IoUring) {
+        while (in_flight_[buffer]) {
+            int done, result;
+            if (!ring_->next(done, result)) {
+                completed(buffer, errno ? errno : EIO);
+                break;
+            }
+            bool short_write = result >= 0 && static_cast<size_t>(result) != submitted_bytes_[done];
+            completed(done, result < 0 ? -result : (short_write ? EIO : 0));
+        }
+    } else {
+        pool_->wait();
+        completed(buffer, pool_error_);
+    }
+    stall_ms_ += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void TrajectoryWriter::completed(int buffer, int error) {
+    in_flight_[buffer] = false;
+    if (error == 0) return;
+
+    // Some filesystems accept O_DIRECT at open and reject the writes; go
+    // through the page cache from here on and rewrite this buffer. Both
+    // buffers may have been in flight with O_DIRECT, so each one retries.
+    #ifdef O_DIRECT
+    if (error == EINVAL && submitted_direct_[buffer]) {
+        if (direct_) {
+            direct_ = false;
+            fcntl(fd_, F_SETFL, fcntl(fd_, F_GETFL) & ~O_DIRECT);
+        }
+        submitted_direct_[buffer] = false;
+        error = pwrite_all(fd_, buffers_[buffer], submitted_bytes_[buffer], submitted_offset_[buffer]);
+        if (error == 0) return;
+    }
+    #endif
+    if (!failed_) {
+        std::cerr << "Trajectory writer: write failed (" << std::strerror(error) << ")" << std::endl;
+    }
+    failed_ = true;
+}
+
+bool TrajectoryWriter::close() {
+    if (fd_ < 0 || closed_) return !failed_;
+    closed_ = true;
+    if (fill_ > 0) {
+        // O_DIRECT lengths must be block multiples: pad, then truncate below
+        size_t padded = (fill_ + kAlignment - 1) / kAlignment * kAlignment;
+        std::memset(buffers_[current_] + fill_, 0, padded - fill_);
+        submit(current_, padded);
+    }
+    waitFor(0);
+    waitFor(1);
+    // The padding past the real end goes; then make the data durable, so the
+    // reported MB/s is what reached the disk
+    if (ftruncate(fd_, static_cast<off_t>(bytes_)) != 0) {
+        std::cerr << "Trajectory writer: truncate failed (" << std::strerror(errno) << ")" << std::endl;
+        failed_ = true;
+    } else if (fdatasync(fd_) != 0) {
+        std::cerr << "Trajectory writer: fdatasync failed (" << std::strerror(errno) << ")" << std::endl;
+        failed_ = true;
+    }
+    if (::close(fd_) != 0) {
+        std::cerr << "Trajectory writer: close failed (" << std::strerror(errno) << ")" << std::endl;
+        failed_ = true;
+    }
+    end_ = Clock::now();
+    return !failed_;
+}
+
+double TrajectoryWriter::seconds() const {
+    return std::chrono::duration<double>((closed_ ? end_ : Clock::now()) - start_).count();
+}
+
+double TrajectoryWriter::megabytesPerSecond() const {
+    double s = seconds();
+    return s > 0.0 ? bytes_ / 1048576.0 / s : 0.0;
+}
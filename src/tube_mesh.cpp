@@ -0,0 +1,172 @@
+// tube_mesh.cpp - Parallel-transport tube generation and streaming upload
+#include "tube_mesh.h"
+#include <algorithm>
+#include <cmath>
+
+#include "memory_tracker.h"
+
+TubeMesh::TubeMesh() {
+    glGenVertexArrays(1, &vao_);
+    glGenBuffers(1, &vbo_);
+    glGenBuffers(1, &ibo_);
+}
+
+TubeMesh::~TubeMesh() {
+    memory::sub(MemTag::GpuBuffers, bufferBytes());
+    glDeleteVertexArrays(1, &vao_);
+    glDeleteBuffers(1, &vbo_);
+    glDeleteBuffers(1, &ibo_);
+}
+
+size_t TubeMesh::bufferBytes() const {
+    return capacity_ * sides_ * (sizeof(Vertex) + 6 * sizeof(GLuint));
+}
+
+int TubeMesh::sidesForRadius(float radius_px) {
+    if (radius_px >= 8.0f) return 16;
+    if (radius_px >= 3.0f) return 8;
+    if (radius_px >= 1.0f) return 6;
+    return 4;
+}
+
+void TubeMesh::reserveRings(size_t rings) {
+    if (rings <= capacity_) return;
+    size_t capacity = std::max<size_t>(rings + rings / 2, 4096);
+    size_t ring_bytes = sides_ * sizeof(Vertex);
+
+    // Grow on the GPU: copy the rings already there into the larger buffer,
+    // oldest first, so they start at slot 0 and no longer wrap
+    GLuint grown;
+    glGenBuffers(1, &grown);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, grown);
+    glBufferData(GL_COPY_WRITE_BUFFER, capacity * ring_bytes, nullptr, GL_DYNAMIC_DRAW);
+    if (rings_ > 0) {
+        size_t head = std::min(rings_, capacity_ - oldest_);
+        glBindBuffer(GL_COPY_READ_BUFFER, vbo_);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, oldest_ * ring_bytes, 0, head * ring_bytes);
+        if (head < rings_) {
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, head * ring_bytes,
+                                (rings_ - head) * ring_bytes);
+        }
+    }
+    glDeleteBuffers(1, &vbo_);
+    vbo_ = grown;
+    oldest_ = 0;
+
+    // Section k joins slot k to slot k + 1, the last one back to slot 0;
+    // quads wind counter-clockwise seen from outside, so back faces can be culled
+    std::vector<GLuint> indices;
+    indices.reserve(capacity * sides_ * 6);
+    for (size_t k = 0; k < capacity; ++k) {
+        GLuint ring0 = static_cast<GLuint>(k * sides_);
+        GLuint ring1 = static_cast<GLuint>((k + 1) % capacity * sides_);
+        for (int j = 0; j < sides_; ++j) {
+            GLuint next = (j + 1) % sides_;
+            indices.insert(indices.end(), {ring0 + j, ring0 + next, ring1 + j,
+                                           ring0 + next, ring1 + next, ring1 + j});
+        }
+    }
+
+    size_t old_bytes = bufferBytes();
+    capacity_ = capacity;
+    memory::replace(MemTag::GpuBuffers, old_bytes, bufferBytes());
+
+    glBindVertexArray(vao_);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, position));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
+    glEnableVertexAttribArray(1);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo_);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+    glBindVertexArray(0);
+}
+
+void TubeMesh::appendRing(const glm::vec3& point, glm::vec3 tangent) {
+    float length = glm::length(tangent);
+    tangent = length > 1e-6f ? tangent / length : glm::vec3(0.0f, 0.0f, 1.0f);
+
+    // Transport the previous normal: drop its tangential part. Restart from an
+    // arbitrary perpendicular on the first ring or if it degenerates.
+    glm::vec3 normal = normal_ - glm::dot(normal_, tangent) * tangent;
+    if (glm::dot(normal, normal) < 1e-8f) {
+        glm::vec3 axis = std::fabs(tangent.x) < 0.9f ? glm::vec3(1, 0, 0) : glm::vec3(0, 1, 0);
+        normal = glm::cross(tangent, axis);
+    }
+    normal = glm::normalize(normal);
+    glm::vec3 binormal = glm::cross(tangent, normal);
+    normal_ = normal;
+
+    for (int j = 0; j < sides_; ++j) {
+        float angle = 6.2831853f * j / sides_;
+        glm::vec3 n = std::cos(angle) * normal + std::sin(angle) * binormal;
+        staging_.push_back({point + radius * n, n});
+    }
+}
+
+size_t TubeMesh::update(const glm::vec3* points, const glm::vec3* tangents, size_t count,
+                        uint64_t first, int sides) {
+    if (!valid_ || sides != sides_ || radius != meshed_radius_) {
+        // Remesh; sizes depend on the ring resolution, every vertex on the radius
+        memory::sub(MemTag::GpuBuffers, bufferBytes());
+        capacity_ = 0;
+        sides_ = sides;
+        meshed_radius_ = radius;
+        rings_ = 0;
+        normal_ = glm::vec3(0.0f);
+        valid_ = true;
+    }
+
+    uint64_t end = first_ + rings_;
+    if (first < first_ || first + count < end) {
+        rings_ = 0;     // Not a continuation of the meshed history
+    } else {
+        // Drop the rings evicted from the front
+        size_t dropped = static_cast<size_t>(std::min<uint64_t>(first - first_, rings_));
+        rings_ -= dropped;
+        oldest_ = rings_ > 0 ? (oldest_ + dropped) % capacity_ : 0;
+    }
+    if (rings_ == 0 && first != end) normal_ = glm::vec3(0.0f);   // Nothing to transport from
+    first_ = first;
+    if (count <= rings_) return 0;
+
+    staging_.clear();
+    for (size_t i = rings_; i < count; ++i) {
+        appendRing(points[i], tangents[i]);
+    }
+    reserveRings(count);
+
+    // The new rings follow the newest one, wrapping at the end of the buffer
+    size_t ring_bytes = sides_ * sizeof(Vertex);
+    size_t slot = (oldest_ + rings_) % capacity_;
+    size_t added = count - rings_;
+    size_t head = std::min(added, capacity_ - slot);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+    glBufferSubData(GL_ARRAY_BUFFER, slot * ring_bytes, head * ring_bytes, staging_.data());
+    if (head < added) {
+        glBufferSubData(GL_ARRAY_BUFFER, 0, (added - head) * ring_bytes, staging_.data() + head * sides_);
+    }
+    rings_ = count;
+    return added;
+}
+
+void TubeMesh::drawRange(size_t first, size_t count) {
+    if (count < 2 || first + count > rings_) return;
+
+    // Sections from the first point's slot; past the end of the buffer the
+    // range continues at slot 0
+    size_t section_indices = sides_ * 6;
+    size_t slot = (oldest_ + first) % capacity_;
+    size_t sections = count - 1;
+    size_t head = std::min(sections, capacity_ - slot);
+    glEnable(GL_CULL_FACE);
+    glBindVertexArray(vao_);
+    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(head * section_indices), GL_UNSIGNED_INT,
+                   (void*)(slot * section_indices * sizeof(GLuint)));
+    if (head < sections) {
+        glDrawElements(GL_TRIANGLES, static_cast<GLsizei>((sections - head) * section_indices),
+                       GL_UNSIGNED_INT, nullptr);
+    }
+    glBindVertexArray(0);
+    glDisable(GL_CULL_FACE);
+}
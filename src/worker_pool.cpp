@@ -0,0 +1,111 @@
+// worker_pool.cpp - Persistent, optionally CPU-pinned worker threads
+#include "worker_pool.h"
+#include <algorithm>
+
+#include "numa_memory.h"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+std::atomic<int> WorkerPool::pending_jobs_{0};
+
+WorkerPool::WorkerPool(int threads, bool pin) {
+    const NumaTopology& topology = NumaTopology::get();
+    int cpu_count = 0;
+    for (const auto& cpus : topology.node_cpus) cpu_count += static_cast<int>(cpus.size());
+    if (threads <= 0) threads = cpu_count;
+
+    // Consecutive workers share a node, so contiguous partitions stay node-local
+    const int nodes = topology.nodeCount();
+    std::vector<int> worker_cpus(threads);
+    worker_nodes_.resize(threads);
+    for (int w = 0; w < threads; ++w) {
+        int node = w * nodes / threads;
+        int first_on_node = (node * threads + nodes - 1) / nodes;
+        const auto& cpus = topology.node_cpus[node];
+        worker_nodes_[w] = node;
+        worker_cpus[w] = cpus[(w - first_on_node) % cpus.size()];
+    }
+
+    threads_.reserve(threads);
+    for (int w = 0; w < threads; ++w) {
+        threads_.emplace_back([this, w]() { workerLoop(w); });
+    }
+
+    #ifdef __linux__
+    if (pin) {
+        pinned_ = true;
+        for (int w = 0; w < threads; ++w) {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(worker_cpus[w], &set);
+            if (pthread_setaffinity_np(threads_[w].native_handle(), sizeof(set), &set) != 0) {
+                pinned_ = false;
+            }
+        }
+    }
+    #else
+    (void)pin;
+    #endif
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (auto& t : threads_) t.join();
+}
+
+void WorkerPool::run(const std::function<void(int, int)>& job) {
+    start(job);
+    wait();
+}
+
+void WorkerPool::start(const std::function<void(int, int)>& job) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_.wait(lock, [this]() { return job_ == nullptr; });
+    job_ = &job;
+    remaining_ = size();
+    pending_jobs_.fetch_add(size(), std::memory_order_relaxed);
+    ++generation_;
+    wake_.notify_all();
+}
+
+void WorkerPool::wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this]() { return remaining_ == 0; });
+    job_ = nullptr;
+    idle_.notify_one();
+}
+
+void WorkerPool::workerLoop(int index) {
+    unsigned long seen = 0;
+    for (;;) {
+        const std::function<void(int, int)>* job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [&]() { return stopping_ || generation_ != seen; });
+            if (stopping_) return;
+            seen = generation_;
+            job = job_;
+        }
+
+        (*job)(index, size());
+        pending_jobs_.fetch_sub(1, std::memory_order_relaxed);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--remaining_ == 0) done_.notify_one();
+    }
+}
+
+void WorkerPool::partition(size_t count, int worker, int workers, size_t granularity,
+                           size_t& begin, size_t& end) {
+    granularity = std::max<size_t>(1, granularity);
+    size_t units = (count + granularity - 1) / granularity;
+    begin = std::min(count, units * worker / workers * granularity);
+    end = std::min(count, units * (worker + 1) / workers * granularity);
+}